@@ -25,6 +25,7 @@ void  actualizar_estad_prom_tiempo(void);
 float expon(float mean);
 
 
+#ifndef SIN_MAIN
 int main(void)  /* Funcion Principal */
 {
     /* Abre los archivos de entrada y salida */
@@ -86,6 +87,7 @@ int main(void)  /* Funcion Principal */
 
     return 0;
 }
+#endif /* SIN_MAIN */
 
 
 void inicializar(void)  /* Funcion de inicializacion. */
@@ -152,8 +154,10 @@ void llegada(void)  /* Funcion de llegada */
 
     /* Programa la siguiente llegada. */
     float prox_llegada = expon(media_entre_llegadas);
+#ifndef SILENCIOSO
     printf("Tiempo %f: LLEGADA - Siguiente en %f (intervalo: %f)\n", 
            tiempo_simulacion, tiempo_simulacion + prox_llegada, prox_llegada);
+#endif
 
     tiempo_sig_evento[1] = tiempo_simulacion + prox_llegada;
 
@@ -276,7 +280,9 @@ float expon(float media)  /* Funcion generadora de la exponencias */
     /* Retorna una variable aleatoria exponencial con media "media"*/
 
     float random_num = lcgrand(1);
+#ifndef SILENCIOSO
     printf("lcgrand(1) = %.10f\n", random_num);  // Ver el número "aleatorio"
+#endif
     return -media * log(random_num);
 }
 
@@ -1,12 +1,34 @@
 /* Implementación de los módulos según capítulo 1.7.1 */
 
+#ifndef _WIN32
+#define _FILE_OFFSET_BITS 64 // fseeko/ftello de 64 bits también en sistemas de 32 bits
+#endif
+
 #include "SistemaDeColasModulo.h"
 #include "lcgrand.cpp"
 
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 /* ========== IMPLEMENTACIÓN MÓDULO 1: INICIALIZACIÓN ========== */
 void ModuloInicializacion::inicializar(TiempoEspacio &T, EstadoSistema &X,
                                        CaracteristicasSistema &theta, ListaEventos &L,
-                                       const ParametrosSistema &xi)
+                                       DerivadasIPA &dtheta, const ParametrosSistema &xi)
 {
     // T ← ⟨ValoresInicialesTiempoEspacio⟩
     T.tiempo_simulacion = 0.0;
@@ -15,24 +37,59 @@ void ModuloInicializacion::inicializar(TiempoEspacio &T, EstadoSistema &X,
     // X ← ⟨ValoresInicialesEstudioSistema⟩
     X.estado_servidor = LIBRE;
     X.num_entra_cola = 0;
+    X.clase_en_servicio = 0;
+    X.llegada_en_servicio = 0.0;
+    ModuloColas::inicializarColas(X);
 
     // θ ← ⟨ValoresInicialesCaracterísticasSistema⟩
     theta.num_clientes_espera = 0;
-    theta.total_de_esperas = 0.0;
-    theta.area_num_entra_cola = 0.0;
-    theta.area_estado_servidor = 0.0;
+    ModuloPrecision::reiniciar(theta.total_de_esperas);
+    ModuloPrecision::reiniciar(theta.area_num_entra_cola);
+    ModuloPrecision::reiniciar(theta.area_estado_servidor);
+    for (int v = 0; v < MAX_VENTANAS; ++v)
+    {
+        theta.llegadas_ventana[v] = 0;
+        theta.clientes_espera_ventana[v] = 0;
+        theta.total_de_esperas_ventana[v] = 0.0;
+        theta.area_num_entra_cola_ventana[v] = 0.0;
+        theta.tiempo_observado_ventana[v] = 0.0;
+    }
+    for (int c = 0; c < MAX_CLASES; ++c)
+    {
+        theta.llegadas_clase[c] = 0;
+        theta.clientes_espera_clase[c] = 0;
+        theta.interrupciones_clase[c] = 0;
+        theta.total_de_esperas_clase[c] = 0.0;
+        theta.area_num_entra_cola_clase[c] = 0.0;
+        theta.tiempo_ultimo_cambio_clase[c] = 0.0;
+    }
+
+    // ∂θ ← ⟨ValoresInicialesDerivadasIPA⟩
+    for (int p = 0; p < NUM_PARAMETROS_IPA; ++p)
+    {
+        dtheta.d_tiempo_simulacion[p] = 0.0;
+        dtheta.d_tiempo_ultimo_evento[p] = 0.0;
+        dtheta.d_tiempo_sig_evento[EVENTO_SALIDA][p] = 0.0;
+        dtheta.d_total_de_esperas[p] = 0.0;
+        dtheta.d_area_num_entra_cola[p] = 0.0;
+    }
 
     // L ← ⟨ValoresInicialesListaEventos⟩
-    L.tiempo_sig_evento[EVENTO_LLEGADA] = T.tiempo_simulacion +
-                                          ModuloPercentil::percentilExponencial(xi.media_entre_llegadas);
+    real_sim tiempo_entre_llegadas = ModuloPercentil::percentilEntreLlegadas(xi, T.tiempo_simulacion);
+    L.tiempo_sig_evento[EVENTO_LLEGADA] = T.tiempo_simulacion + tiempo_entre_llegadas;
     L.tiempo_sig_evento[EVENTO_SALIDA] = 1.0e+30; // Infinito (no hay cliente en servicio)
+
+    // Con perfil las llegadas no dependen de media_entre_llegadas
+    ModuloGradientes::programarEvento(dtheta, EVENTO_LLEGADA, PARAM_ENTRE_LLEGADAS,
+                                      xi.perfil ? 0.0 : tiempo_entre_llegadas,
+                                      xi.media_entre_llegadas);
 }
 
 /* ========== IMPLEMENTACIÓN MÓDULO 2: MANEJO TIEMPO-ESPACIO ========== */
 int ModuloManejoTiempo::manejoTiempoEspacio(TiempoEspacio &T, ListaEventos &L,
-                                            const ParametrosSistema &xi)
+                                            DerivadasIPA &dtheta, const ParametrosSistema &xi)
 {
-    float min_tiempo_sig_evento = 1.0e+29;
+    real_sim min_tiempo_sig_evento = 1.0e+29;
     int k_estrella = 0; // k* en el algoritmo
 
     // k* ← {k|L[k] = min{L[γ]}}
@@ -55,6 +112,12 @@ int ModuloManejoTiempo::manejoTiempoEspacio(TiempoEspacio &T, ListaEventos &L,
     // T ← L[k*]
     T.tiempo_simulacion = min_tiempo_sig_evento;
 
+    // ∂T ← ∂L[k*]
+    for (int p = 0; p < NUM_PARAMETROS_IPA; ++p)
+    {
+        dtheta.d_tiempo_simulacion[p] = dtheta.d_tiempo_sig_evento[k_estrella][p];
+    }
+
     // RETORNAR(k*)
     return k_estrella;
 }
@@ -62,10 +125,11 @@ int ModuloManejoTiempo::manejoTiempoEspacio(TiempoEspacio &T, ListaEventos &L,
 /* ========== IMPLEMENTACIÓN MÓDULO 3: EVENTOS ========== */
 void ModuloEventos::eventoLlegada(EstadoSistema &X, CaracteristicasSistema &theta,
                                   ListaEventos &L, const TiempoEspacio &T,
-                                  const ParametrosSistema &xi, RegistroEventos &registro)
+                                  DerivadasIPA &dtheta, const ParametrosSistema &xi,
+                                  RegistroEventos &registro)
 {
-    float espera;
-    float tiempo_entre_llegadas = 0.0;
+    real_sim espera;
+    real_sim tiempo_entre_llegadas = 0.0;
 
     // Calcular tiempo entre llegadas para el logging
     if (registro.ultimo_tiempo_llegada >= 0.0)
@@ -84,12 +148,35 @@ void ModuloEventos::eventoLlegada(EstadoSistema &X, CaracteristicasSistema &thet
     // Incrementar contador de clientes (para logging)
     registro.numero_cliente++;
 
+    // Ventana del perfil en la que llega el cliente
+    int ventana = 0;
+    double fin_ventana;
+    if (xi.perfil)
+    {
+        ventana = ModuloPerfil::ventana(*xi.perfil, T.tiempo_simulacion, fin_ventana);
+        ++theta.llegadas_ventana[ventana];
+    }
+
+    // Clase del cliente que llega
+    int clase = 0;
+    if (xi.clases)
+    {
+        clase = ModuloClases::elegirClase(*xi.clases);
+        ++theta.llegadas_clase[clase];
+    }
+
     // L ← ⟨ActualizarListaEventos⟩
-    L.tiempo_sig_evento[EVENTO_LLEGADA] = T.tiempo_simulacion +
-                                          ModuloPercentil::percentilExponencial(xi.media_entre_llegadas);
+    real_sim prox_llegada = ModuloPercentil::percentilEntreLlegadas(xi, T.tiempo_simulacion);
+    L.tiempo_sig_evento[EVENTO_LLEGADA] = T.tiempo_simulacion + prox_llegada;
+    ModuloGradientes::programarEvento(dtheta, EVENTO_LLEGADA, PARAM_ENTRE_LLEGADAS,
+                                      xi.perfil ? 0.0 : prox_llegada, xi.media_entre_llegadas);
+
+    // Con prioridad apropiativa, una clase más prioritaria interrumpe al cliente en servicio
+    bool interrumpir = X.estado_servidor == OCUPADO && xi.clases &&
+                       xi.clases->apropiativa && clase < X.clase_en_servicio;
 
     // X ← ⟨ActualizarEstudioSistema⟩
-    if (X.estado_servidor == OCUPADO)
+    if (X.estado_servidor == OCUPADO && !interrumpir)
     {
         ++X.num_entra_cola;
 
@@ -99,24 +186,71 @@ void ModuloEventos::eventoLlegada(EstadoSistema &X, CaracteristicasSistema &thet
             exit(2);
         }
 
-        X.tiempo_llegada[X.num_entra_cola] = T.tiempo_simulacion;
+        ModuloColas::acumularAreaClase(X, theta, clase, T.tiempo_simulacion);
+        int espacio = ModuloColas::encolar(X, clase, false);
+        X.tiempo_llegada[espacio] = T.tiempo_simulacion;
+        X.llegada_original[espacio] = T.tiempo_simulacion;
+        X.atencion_restante[espacio] = -1.0;
+        for (int p = 0; p < NUM_PARAMETROS_IPA; ++p)
+        {
+            dtheta.d_tiempo_llegada[espacio][p] = dtheta.d_tiempo_simulacion[p];
+        }
         
         // Guardar datos del cliente para logging posterior (cuando sea atendido)
-        registro.clientes_en_cola[X.num_entra_cola].numero = registro.numero_cliente;
-        registro.clientes_en_cola[X.num_entra_cola].tiempo_entre_llegadas = tiempo_entre_llegadas;
-        registro.clientes_en_cola[X.num_entra_cola].tiempo_llegada = T.tiempo_simulacion;
+        registro.clientes_en_cola[espacio].numero = registro.numero_cliente;
+        registro.clientes_en_cola[espacio].tiempo_entre_llegadas = tiempo_entre_llegadas;
+        registro.clientes_en_cola[espacio].tiempo_llegada = T.tiempo_simulacion;
     }
     else
     {
+        if (interrumpir)
+        {
+            // El cliente interrumpido vuelve al frente de la cola de su clase
+            ++X.num_entra_cola;
+
+            if (X.num_entra_cola > LIMITE_COLA)
+            {
+                fprintf(stderr, "\nDesbordamiento de la cola en tiempo %f", T.tiempo_simulacion);
+                exit(2);
+            }
+
+            int clase_interrumpida = X.clase_en_servicio;
+            ModuloColas::acumularAreaClase(X, theta, clase_interrumpida, T.tiempo_simulacion);
+            int espacio = ModuloColas::encolar(X, clase_interrumpida, true);
+            X.tiempo_llegada[espacio] = T.tiempo_simulacion;
+            X.llegada_original[espacio] = X.llegada_en_servicio;
+            X.atencion_restante[espacio] = L.tiempo_sig_evento[EVENTO_SALIDA] - T.tiempo_simulacion;
+            for (int p = 0; p < NUM_PARAMETROS_IPA; ++p)
+            {
+                dtheta.d_tiempo_llegada[espacio][p] = dtheta.d_tiempo_simulacion[p];
+            }
+            registro.clientes_en_cola[espacio] = registro.cliente_en_servicio;
+            ++theta.interrupciones_clase[clase_interrumpida];
+        }
+
         espera = 0.0;
-        theta.total_de_esperas += espera;
+        ModuloPrecision::sumar(theta.total_de_esperas, espera);
 
         ++theta.num_clientes_espera;
         X.estado_servidor = OCUPADO;
+        X.clase_en_servicio = clase;
+        X.llegada_en_servicio = T.tiempo_simulacion;
+
+        if (xi.perfil)
+        {
+            ++theta.clientes_espera_ventana[ventana];
+        }
+        if (xi.clases)
+        {
+            ++theta.clientes_espera_clase[clase];
+        }
 
         // Generar tiempo de atención
-        float tiempo_atencion = ModuloPercentil::percentilExponencial(xi.media_atencion);
+        float media_atencion = xi.clases ? xi.clases->media_atencion[clase] : xi.media_atencion;
+        real_sim tiempo_atencion = ModuloPercentil::percentilExponencial(media_atencion);
         L.tiempo_sig_evento[EVENTO_SALIDA] = T.tiempo_simulacion + tiempo_atencion;
+        ModuloGradientes::programarEvento(dtheta, EVENTO_SALIDA, PARAM_ATENCION,
+                                          tiempo_atencion, media_atencion);
         
         // Registrar datos del cliente que comienza atención inmediatamente
         registro.cliente_en_servicio.numero = registro.numero_cliente;
@@ -127,9 +261,10 @@ void ModuloEventos::eventoLlegada(EstadoSistema &X, CaracteristicasSistema &thet
 
 void ModuloEventos::eventoSalida(EstadoSistema &X, CaracteristicasSistema &theta,
                                  ListaEventos &L, const TiempoEspacio &T,
-                                 const ParametrosSistema &xi, RegistroEventos &registro)
+                                 DerivadasIPA &dtheta, const ParametrosSistema &xi,
+                                 RegistroEventos &registro)
 {
-    float espera;
+    real_sim espera;
 
     // Escribir datos del cliente que termina su atención
     ModuloRegistro::escribirEventoCliente(registro.cliente_en_servicio, registro.archivo_log);
@@ -149,63 +284,632 @@ void ModuloEventos::eventoSalida(EstadoSistema &X, CaracteristicasSistema &theta
     {
         --X.num_entra_cola;
 
+        // El primer cliente de la clase más prioritaria pasa a ser atendido
+        int clase = ModuloColas::claseMayorPrioridad(X);
+        ModuloColas::acumularAreaClase(X, theta, clase, T.tiempo_simulacion);
+        int espacio = ModuloColas::desencolar(X, clase);
+        bool reanudar = X.atencion_restante[espacio] >= 0.0;
+
         // θ ← ⟨ActualizarCalculoCaracterísticas⟩
-        espera = T.tiempo_simulacion - X.tiempo_llegada[1];
-        theta.total_de_esperas += espera;
+        espera = T.tiempo_simulacion - X.tiempo_llegada[espacio];
+        ModuloPrecision::sumar(theta.total_de_esperas, espera);
 
-        ++theta.num_clientes_espera;
+        // ∂θ ← ⟨ActualizarDerivadasEspera⟩: ∂espera = ∂T - ∂(tiempo de llegada)
+        for (int p = 0; p < NUM_PARAMETROS_IPA; ++p)
+        {
+            dtheta.d_total_de_esperas[p] += dtheta.d_tiempo_simulacion[p] -
+                                            dtheta.d_tiempo_llegada[espacio][p];
+        }
 
-        // Generar tiempo de atención para el siguiente cliente
-        float tiempo_atencion = ModuloPercentil::percentilExponencial(xi.media_atencion);
-        L.tiempo_sig_evento[EVENTO_SALIDA] = T.tiempo_simulacion + tiempo_atencion;
+        // Un cliente interrumpido suma su nueva espera pero no se cuenta de nuevo
+        if (!reanudar)
+        {
+            ++theta.num_clientes_espera;
+        }
 
-        // El primer cliente en cola pasa a ser atendido
-        registro.cliente_en_servicio = registro.clientes_en_cola[1];
-        registro.cliente_en_servicio.tiempo_atencion = tiempo_atencion;
+        // La espera se asigna a la ventana en que llegó el cliente, aunque haya sido interrumpido
+        if (xi.perfil)
+        {
+            double fin_ventana;
+            int ventana = ModuloPerfil::ventana(*xi.perfil, X.llegada_original[espacio], fin_ventana);
+            theta.total_de_esperas_ventana[ventana] += espera;
+            if (!reanudar)
+            {
+                ++theta.clientes_espera_ventana[ventana];
+            }
+        }
+        if (xi.clases)
+        {
+            theta.total_de_esperas_clase[clase] += espera;
+            if (!reanudar)
+            {
+                ++theta.clientes_espera_clase[clase];
+            }
+        }
+
+        // Generar tiempo de atención para el siguiente cliente (o reanudar el interrumpido)
+        float media_atencion = xi.clases ? xi.clases->media_atencion[clase] : xi.media_atencion;
+        real_sim tiempo_atencion = reanudar ? X.atencion_restante[espacio]
+                                         : ModuloPercentil::percentilExponencial(media_atencion);
+        L.tiempo_sig_evento[EVENTO_SALIDA] = T.tiempo_simulacion + tiempo_atencion;
+        ModuloGradientes::programarEvento(dtheta, EVENTO_SALIDA, PARAM_ATENCION,
+                                          tiempo_atencion, media_atencion);
+        X.clase_en_servicio = clase;
+        X.llegada_en_servicio = X.llegada_original[espacio];
 
-        // Mover clientes en la cola
-        for (int i = 1; i <= X.num_entra_cola; ++i)
+        registro.cliente_en_servicio = registro.clientes_en_cola[espacio];
+        if (!reanudar)
         {
-            X.tiempo_llegada[i] = X.tiempo_llegada[i + 1];
-            registro.clientes_en_cola[i] = registro.clientes_en_cola[i + 1];
+            registro.cliente_en_servicio.tiempo_atencion = tiempo_atencion;
         }
     }
 }
 
 void ModuloEventos::actualizarEstadisticasPromedio(const EstadoSistema &X,
                                                    CaracteristicasSistema &theta,
-                                                   TiempoEspacio &T)
+                                                   TiempoEspacio &T,
+                                                   DerivadasIPA &dtheta,
+                                                   const ParametrosSistema &xi)
 {
-    float tiempo_desde_ultimo_evento = T.tiempo_simulacion - T.tiempo_ultimo_evento;
+    real_sim tiempo_desde_ultimo_evento = T.tiempo_simulacion - T.tiempo_ultimo_evento;
+
+    // Repartir el intervalo entre las ventanas del perfil que atraviesa
+    if (xi.perfil)
+    {
+        double inicio = T.tiempo_ultimo_evento;
+        while (inicio < T.tiempo_simulacion)
+        {
+            double fin_ventana;
+            int ventana = ModuloPerfil::ventana(*xi.perfil, inicio, fin_ventana);
+            double fin = (fin_ventana < T.tiempo_simulacion) ? fin_ventana : T.tiempo_simulacion;
+
+            theta.area_num_entra_cola_ventana[ventana] += X.num_entra_cola * (fin - inicio);
+            theta.tiempo_observado_ventana[ventana] += fin - inicio;
+            inicio = fin;
+        }
+    }
+
     T.tiempo_ultimo_evento = T.tiempo_simulacion;
 
-    theta.area_num_entra_cola += X.num_entra_cola * tiempo_desde_ultimo_evento;
-    theta.area_estado_servidor += X.estado_servidor * tiempo_desde_ultimo_evento;
+    ModuloPrecision::sumar(theta.area_num_entra_cola, X.num_entra_cola * tiempo_desde_ultimo_evento);
+    ModuloPrecision::sumar(theta.area_estado_servidor, X.estado_servidor * tiempo_desde_ultimo_evento);
+
+    // ∂área ← ∂área + Q(t) · (∂T - ∂T_ultimo)
+    for (int p = 0; p < NUM_PARAMETROS_IPA; ++p)
+    {
+        dtheta.d_area_num_entra_cola[p] += X.num_entra_cola *
+                                           (dtheta.d_tiempo_simulacion[p] - dtheta.d_tiempo_ultimo_evento[p]);
+        dtheta.d_tiempo_ultimo_evento[p] = dtheta.d_tiempo_simulacion[p];
+    }
+}
+
+/* ========== IMPLEMENTACIÓN MÓDULO 12: PRECISIÓN ========== */
+void ModuloPrecision::reiniciar(Acumulador &acumulador)
+{
+    acumulador.suma = 0.0;
+    acumulador.compensacion = 0.0;
+}
+
+void ModuloPrecision::sumar(Acumulador &acumulador, real_sim valor)
+{
+#ifdef CORRIDA_LARGA
+    // Suma de Neumaier: guarda los bits que se pierden al sumar
+    real_sim suma = acumulador.suma + valor;
+    if (fabs(acumulador.suma) >= fabs(valor))
+    {
+        acumulador.compensacion += (acumulador.suma - suma) + valor;
+    }
+    else
+    {
+        acumulador.compensacion += (valor - suma) + acumulador.suma;
+    }
+    acumulador.suma = suma;
+#else
+    acumulador.suma += valor;
+#endif
+}
+
+real_sim ModuloPrecision::valor(const Acumulador &acumulador)
+{
+    return acumulador.suma + acumulador.compensacion;
+}
+
+/* ========== IMPLEMENTACIÓN MÓDULO 13: GENERADOR ALEATORIO ========== */
+#ifdef CORRIDA_LARGA
+// MRG32k3a de L'Ecuyer (implementación en double), semillas por omisión 12345
+#define MRG_NORMA 2.328306549295727688e-10
+#define MRG_M1 4294967087.0
+#define MRG_M2 4294944443.0
+#define MRG_A12 1403580.0
+#define MRG_A13N 810728.0
+#define MRG_A21 527612.0
+#define MRG_A23N 1370589.0
+
+static EstadoAleatorio estado_mrg = {{12345.0, 12345.0, 12345.0}, {12345.0, 12345.0, 12345.0}};
+#endif
+
+double ModuloAleatorio::uniforme()
+{
+#ifdef CORRIDA_LARGA
+    // Componente 1: p1 ← (a12·s1[1] − a13n·s1[0]) mod m1
+    double p1 = MRG_A12 * estado_mrg.s1[1] - MRG_A13N * estado_mrg.s1[0];
+    p1 -= (long long)(p1 / MRG_M1) * MRG_M1;
+    if (p1 < 0.0)
+    {
+        p1 += MRG_M1;
+    }
+    estado_mrg.s1[0] = estado_mrg.s1[1];
+    estado_mrg.s1[1] = estado_mrg.s1[2];
+    estado_mrg.s1[2] = p1;
+
+    // Componente 2: p2 ← (a21·s2[2] − a23n·s2[0]) mod m2
+    double p2 = MRG_A21 * estado_mrg.s2[2] - MRG_A23N * estado_mrg.s2[0];
+    p2 -= (long long)(p2 / MRG_M2) * MRG_M2;
+    if (p2 < 0.0)
+    {
+        p2 += MRG_M2;
+    }
+    estado_mrg.s2[0] = estado_mrg.s2[1];
+    estado_mrg.s2[1] = estado_mrg.s2[2];
+    estado_mrg.s2[2] = p2;
+
+    // u ← ((p1 − p2) mod m1) / (m1 + 1), en (0, 1)
+    return (p1 > p2) ? (p1 - p2) * MRG_NORMA : (p1 - p2 + MRG_M1) * MRG_NORMA;
+#else
+    return lcgrand(FLUJO_ALEATORIO);
+#endif
+}
+
+void ModuloAleatorio::obtenerEstado(EstadoAleatorio &estado)
+{
+#ifdef CORRIDA_LARGA
+    estado = estado_mrg;
+#else
+    estado.z = zrng[FLUJO_ALEATORIO];
+#endif
+}
+
+void ModuloAleatorio::fijarEstado(const EstadoAleatorio &estado)
+{
+#ifdef CORRIDA_LARGA
+    estado_mrg = estado;
+#else
+    zrng[FLUJO_ALEATORIO] = estado.z;
+#endif
+}
+
+/* ========== IMPLEMENTACIÓN MÓDULO 10: COLAS POR CLASE ========== */
+static inline int contarCerosFinales(unsigned long long mapa)
+{
+#ifdef _MSC_VER
+    unsigned long indice;
+    _BitScanForward64(&indice, mapa);
+    return (int)indice;
+#else
+    return __builtin_ctzll(mapa);
+#endif
+}
+
+void ModuloColas::inicializarColas(EstadoSistema &X)
+{
+    for (int c = 0; c < MAX_CLASES; ++c)
+    {
+        X.inicio_cola[c] = 0;
+        X.tamano_cola[c] = 0;
+    }
+    X.clases_no_vacias = 0;
+
+    // Pila de espacios libres: el primero en salir es el espacio 1
+    X.num_espacios_libres = LIMITE_COLA;
+    for (int i = 0; i < LIMITE_COLA; ++i)
+    {
+        X.espacios_libres[i] = LIMITE_COLA - i;
+    }
+}
+
+int ModuloColas::encolar(EstadoSistema &X, int clase, bool al_frente)
+{
+    int espacio = X.espacios_libres[--X.num_espacios_libres];
+    X.clase_cliente[espacio] = clase;
+
+    if (al_frente)
+    {
+        X.inicio_cola[clase] = (X.inicio_cola[clase] + LIMITE_COLA - 1) % LIMITE_COLA;
+        X.cola_clase[clase][X.inicio_cola[clase]] = espacio;
+    }
+    else
+    {
+        X.cola_clase[clase][(X.inicio_cola[clase] + X.tamano_cola[clase]) % LIMITE_COLA] = espacio;
+    }
+
+    ++X.tamano_cola[clase];
+    X.clases_no_vacias |= 1ULL << clase;
+    return espacio;
+}
+
+int ModuloColas::claseMayorPrioridad(const EstadoSistema &X)
+{
+    // La clase 0 es la más prioritaria: el bit encendido más bajo, en O(1)
+    return contarCerosFinales(X.clases_no_vacias);
+}
+
+int ModuloColas::desencolar(EstadoSistema &X, int clase)
+{
+    // El espacio queda libre, pero sus datos siguen válidos hasta el próximo encolar
+    int espacio = X.cola_clase[clase][X.inicio_cola[clase]];
+    X.inicio_cola[clase] = (X.inicio_cola[clase] + 1) % LIMITE_COLA;
+
+    if (--X.tamano_cola[clase] == 0)
+    {
+        X.clases_no_vacias &= ~(1ULL << clase);
+    }
+
+    X.espacios_libres[X.num_espacios_libres++] = espacio;
+    return espacio;
+}
+
+void ModuloColas::acumularAreaClase(const EstadoSistema &X, CaracteristicasSistema &theta,
+                                    int clase, real_sim tiempo)
+{
+    // Sólo se actualiza la clase cuyo tamaño va a cambiar
+    theta.area_num_entra_cola_clase[clase] += X.tamano_cola[clase] *
+                                              (tiempo - theta.tiempo_ultimo_cambio_clase[clase]);
+    theta.tiempo_ultimo_cambio_clase[clase] = tiempo;
+}
+
+void ModuloColas::cerrarAreasClase(const EstadoSistema &X, CaracteristicasSistema &theta,
+                                   const TiempoEspacio &T)
+{
+    for (int c = 0; c < MAX_CLASES; ++c)
+    {
+        acumularAreaClase(X, theta, c, T.tiempo_simulacion);
+    }
+}
+
+/* ========== IMPLEMENTACIÓN MÓDULO 11: CLASES DE CLIENTES ========== */
+bool ModuloClases::cargarClases(ClasesClientes &clases, FILE *archivo)
+{
+    char modo[16];
+
+    // Primera línea: APROPIATIVA o NO_APROPIATIVA; luego "media_entre_llegadas media_atencion"
+    // por clase, de la más prioritaria a la menos prioritaria
+    if (fscanf(archivo, "%15s", modo) != 1)
+    {
+        return false;
+    }
+    if (strcmp(modo, "APROPIATIVA") == 0)
+    {
+        clases.apropiativa = 1;
+    }
+    else if (strcmp(modo, "NO_APROPIATIVA") == 0)
+    {
+        clases.apropiativa = 0;
+    }
+    else
+    {
+        fprintf(stderr, "Modo de prioridad desconocido: %s\n", modo);
+        return false;
+    }
+
+    clases.num_clases = 0;
+    int leidos = 0;
+    while (clases.num_clases < MAX_CLASES &&
+           (leidos = fscanf(archivo, "%f %f", &clases.media_entre_llegadas[clases.num_clases],
+                            &clases.media_atencion[clases.num_clases])) == 2)
+    {
+        if (clases.media_entre_llegadas[clases.num_clases] <= 0.0 ||
+            clases.media_atencion[clases.num_clases] <= 0.0)
+        {
+            fprintf(stderr, "Medias inválidas en la clase %d\n", clases.num_clases);
+            return false;
+        }
+        ++clases.num_clases;
+    }
+
+    // Lo que quede en el archivo es un error: más clases de las que caben o una línea mal formada
+    char resto;
+    if (leidos == 1 || fscanf(archivo, " %c", &resto) == 1)
+    {
+        if (clases.num_clases == MAX_CLASES)
+        {
+            fprintf(stderr, "El archivo define más de %d clases\n", MAX_CLASES);
+        }
+        else
+        {
+            fprintf(stderr, "Línea inválida después de la clase %d\n", clases.num_clases);
+        }
+        return false;
+    }
+
+    if (clases.num_clases == 0)
+    {
+        fprintf(stderr, "El archivo de clases no define ninguna clase\n");
+        return false;
+    }
+
+    // Tabla de alias (Vose) con probabilidades proporcionales a la tasa de cada clase
+    int n = clases.num_clases;
+    float tasa_total = 0.0;
+    float escalada[MAX_CLASES];
+    int pequenas[MAX_CLASES], grandes[MAX_CLASES];
+    int num_pequenas = 0, num_grandes = 0;
+
+    for (int c = 0; c < n; ++c)
+    {
+        tasa_total += 1.0 / clases.media_entre_llegadas[c];
+    }
+    for (int c = 0; c < n; ++c)
+    {
+        escalada[c] = n / (clases.media_entre_llegadas[c] * tasa_total);
+        if (escalada[c] < 1.0)
+        {
+            pequenas[num_pequenas++] = c;
+        }
+        else
+        {
+            grandes[num_grandes++] = c;
+        }
+    }
+    while (num_pequenas > 0 && num_grandes > 0)
+    {
+        int menor = pequenas[--num_pequenas];
+        int mayor = grandes[--num_grandes];
+        clases.prob_alias[menor] = escalada[menor];
+        clases.alias[menor] = mayor;
+
+        escalada[mayor] -= 1.0 - escalada[menor];
+        if (escalada[mayor] < 1.0)
+        {
+            pequenas[num_pequenas++] = mayor;
+        }
+        else
+        {
+            grandes[num_grandes++] = mayor;
+        }
+    }
+    while (num_grandes > 0)
+    {
+        int c = grandes[--num_grandes];
+        clases.prob_alias[c] = 1.0;
+        clases.alias[c] = c;
+    }
+    while (num_pequenas > 0)
+    {
+        // Sólo por redondeo: queda con probabilidad completa
+        int c = pequenas[--num_pequenas];
+        clases.prob_alias[c] = 1.0;
+        clases.alias[c] = c;
+    }
+    return true;
+}
+
+int ModuloClases::elegirClase(const ClasesClientes &clases)
+{
+    // Una sola uniforme: la parte entera elige la columna y la fraccionaria el alias
+    float x = ModuloAleatorio::uniforme() * clases.num_clases;
+    int columna = (int)x;
+    if (columna >= clases.num_clases)
+    {
+        columna = clases.num_clases - 1;
+    }
+    return (x - columna < clases.prob_alias[columna]) ? columna : clases.alias[columna];
 }
 
 /* ========== IMPLEMENTACIÓN MÓDULO 4: PERCENTIL ========== */
-float ModuloPercentil::percentilExponencial(float media)
+real_sim ModuloPercentil::percentilExponencial(real_sim media)
 {
     // u ← Aleatorio(•)
-    float u = lcgrand(1);
+    real_sim u = ModuloAleatorio::uniforme();
 
     // x ← F_x^(-1)(u)
-    float x = -media * log(u);
+    real_sim x = -media * log(u);
 
     // RETORNAR(x)
     return x;
 }
 
+real_sim ModuloPercentil::percentilLlegadaNoHomogenea(const PerfilTasas &perfil, double tiempo_actual)
+{
+    // u ← Aleatorio(•); e ~ Exp(1)
+    double e = -log(ModuloAleatorio::uniforme());
+
+    // t ← Λ⁻¹(Λ(T) + e): inversión exacta, sin candidatos rechazados
+    double siguiente = ModuloPerfil::invertirTasaAcumulada(
+        perfil, ModuloPerfil::tasaAcumulada(perfil, tiempo_actual) + e);
+
+    // RETORNAR(t - T)
+    return (real_sim)(siguiente - tiempo_actual);
+}
+
+real_sim ModuloPercentil::percentilEntreLlegadas(const ParametrosSistema &xi, double tiempo_actual)
+{
+    if (xi.perfil)
+    {
+        return percentilLlegadaNoHomogenea(*xi.perfil, tiempo_actual);
+    }
+    return percentilExponencial(xi.media_entre_llegadas);
+}
+
+/* ========== IMPLEMENTACIÓN MÓDULO 9: PERFIL DE TASAS ========== */
+static int buscarSegmento(const double *puntos, int num_puntos, double valor)
+{
+    // Búsqueda binaria del último i en [0, num_puntos - 2] con puntos[i] <= valor
+    int bajo = 0, alto = num_puntos - 2;
+    while (bajo < alto)
+    {
+        int medio = (bajo + alto + 1) / 2;
+        if (puntos[medio] <= valor)
+        {
+            bajo = medio;
+        }
+        else
+        {
+            alto = medio - 1;
+        }
+    }
+    return bajo;
+}
+
+bool ModuloPerfil::cargarPerfil(PerfilTasas &perfil, FILE *archivo)
+{
+    char modo[16];
+
+    // Primera línea: CONSTANTE o LINEAL; luego pares "tiempo tasa"
+    if (fscanf(archivo, "%15s", modo) != 1)
+    {
+        return false;
+    }
+    if (strcmp(modo, "CONSTANTE") == 0)
+    {
+        perfil.modo = PERFIL_CONSTANTE;
+    }
+    else if (strcmp(modo, "LINEAL") == 0)
+    {
+        perfil.modo = PERFIL_LINEAL;
+    }
+    else
+    {
+        fprintf(stderr, "Modo de perfil desconocido: %s\n", modo);
+        return false;
+    }
+
+    perfil.num_puntos = 0;
+    int leidos = 0;
+    while (perfil.num_puntos <= MAX_VENTANAS &&
+           (leidos = fscanf(archivo, "%lf %lf", &perfil.tiempo[perfil.num_puntos],
+                            &perfil.tasa[perfil.num_puntos])) == 2)
+    {
+        ++perfil.num_puntos;
+    }
+
+    // Lo que quede en el archivo es un error: más puntos de los que caben o un dato mal formado
+    char resto;
+    if (leidos == 1 || fscanf(archivo, " %c", &resto) == 1)
+    {
+        if (perfil.num_puntos > MAX_VENTANAS)
+        {
+            fprintf(stderr, "El perfil tiene más de %d ventanas\n", MAX_VENTANAS);
+        }
+        else
+        {
+            fprintf(stderr, "Dato inválido en el perfil después del punto %d\n", perfil.num_puntos);
+        }
+        return false;
+    }
+
+    if (perfil.num_puntos < 2 || perfil.tiempo[0] != 0.0)
+    {
+        fprintf(stderr, "El perfil necesita al menos dos puntos y empezar en tiempo 0\n");
+        return false;
+    }
+
+    // Λ(tiempo[i]) acumulada por segmentos
+    perfil.acumulada[0] = 0.0;
+    for (int i = 0; i + 1 < perfil.num_puntos; ++i)
+    {
+        double ancho = perfil.tiempo[i + 1] - perfil.tiempo[i];
+        if (ancho <= 0.0 || perfil.tasa[i] < 0.0 || perfil.tasa[i + 1] < 0.0)
+        {
+            fprintf(stderr, "Perfil inválido en el punto %d\n", i + 1);
+            return false;
+        }
+
+        double masa = (perfil.modo == PERFIL_CONSTANTE)
+                          ? perfil.tasa[i] * ancho
+                          : 0.5 * (perfil.tasa[i] + perfil.tasa[i + 1]) * ancho;
+        perfil.acumulada[i + 1] = perfil.acumulada[i] + masa;
+    }
+
+    if (perfil.acumulada[perfil.num_puntos - 1] <= 0.0)
+    {
+        fprintf(stderr, "El perfil no tiene llegadas en todo el periodo\n");
+        return false;
+    }
+    return true;
+}
+
+int ModuloPerfil::ventana(const PerfilTasas &perfil, double tiempo, double &fin_ventana)
+{
+    int n = perfil.num_puntos;
+    double periodo = perfil.tiempo[n - 1];
+    double inicio_periodo = floor(tiempo / periodo) * periodo;
+    int bajo = buscarSegmento(perfil.tiempo, n, tiempo - inicio_periodo);
+
+    fin_ventana = inicio_periodo + perfil.tiempo[bajo + 1];
+    if (fin_ventana <= tiempo)
+    {
+        // Redondeo justo en el borde: pasar a la siguiente ventana
+        bajo = (bajo + 1) % (n - 1);
+        fin_ventana = (bajo == 0) ? inicio_periodo + periodo + perfil.tiempo[1]
+                                  : inicio_periodo + perfil.tiempo[bajo + 1];
+    }
+    return bajo;
+}
+
+double ModuloPerfil::tasaAcumulada(const PerfilTasas &perfil, double tiempo)
+{
+    int n = perfil.num_puntos;
+    double periodo = perfil.tiempo[n - 1];
+    double num_periodos = floor(tiempo / periodo);
+    double t = tiempo - num_periodos * periodo;
+    int i = buscarSegmento(perfil.tiempo, n, t);
+    double x = t - perfil.tiempo[i];
+
+    // Λ(t) = k·Λ(P) + Λ(tiempo[i]) + ∫ tasa en el segmento i
+    double dentro = perfil.tasa[i] * x;
+    if (perfil.modo == PERFIL_LINEAL)
+    {
+        double pendiente = (perfil.tasa[i + 1] - perfil.tasa[i]) /
+                           (perfil.tiempo[i + 1] - perfil.tiempo[i]);
+        dentro += 0.5 * pendiente * x * x;
+    }
+    return num_periodos * perfil.acumulada[n - 1] + perfil.acumulada[i] + dentro;
+}
+
+double ModuloPerfil::invertirTasaAcumulada(const PerfilTasas &perfil, double acumulada)
+{
+    int n = perfil.num_puntos;
+    double total = perfil.acumulada[n - 1];
+    double num_periodos = floor(acumulada / total);
+    double y = acumulada - num_periodos * total;
+
+    // Segmento con acumulada[i] <= y < acumulada[i + 1] (salta los de tasa cero)
+    int bajo = buscarSegmento(perfil.acumulada, n, y);
+
+    // Resolver ∫ tasa = y - acumulada[i] dentro del segmento
+    double resto = y - perfil.acumulada[bajo];
+    double x;
+    if (resto <= 0.0)
+    {
+        x = 0.0;
+    }
+    else if (perfil.modo == PERFIL_CONSTANTE)
+    {
+        x = resto / perfil.tasa[bajo];
+    }
+    else
+    {
+        // tasa·x + pendiente·x²/2 = resto, en forma numéricamente estable
+        double pendiente = (perfil.tasa[bajo + 1] - perfil.tasa[bajo]) /
+                           (perfil.tiempo[bajo + 1] - perfil.tiempo[bajo]);
+        double r0 = perfil.tasa[bajo];
+        x = 2.0 * resto / (r0 + sqrt(r0 * r0 + 2.0 * pendiente * resto));
+    }
+
+    return num_periodos * perfil.tiempo[n - 1] + perfil.tiempo[bajo] + x;
+}
+
 /* ========== IMPLEMENTACIÓN MÓDULO 5: REPORTES ========== */
 void ModuloReportes::generarReporte(const CaracteristicasSistema &theta,
                                     const TiempoEspacio &T,
+                                    const DerivadasIPA &dtheta,
                                     const ParametrosSistema &xi,
                                     FILE *archivo_salida)
 {
     // θ ← ⟨CalculoFinalDeCaracterísticas⟩
-    float espera_promedio = theta.total_de_esperas / theta.num_clientes_espera;
-    float num_promedio_cola = theta.area_num_entra_cola / T.tiempo_simulacion;
-    float utilizacion_servidor = theta.area_estado_servidor / T.tiempo_simulacion;
+    real_sim espera_promedio = ModuloPrecision::valor(theta.total_de_esperas) / theta.num_clientes_espera;
+    real_sim num_promedio_cola = ModuloPrecision::valor(theta.area_num_entra_cola) / T.tiempo_simulacion;
+    real_sim utilizacion_servidor = ModuloPrecision::valor(theta.area_estado_servidor) / T.tiempo_simulacion;
 
     // ESCRIBIR(θ)
     fprintf(archivo_salida, "\n\n==== REPORTE FINAL DE SIMULACIÓN ====\n");
@@ -213,7 +917,476 @@ void ModuloReportes::generarReporte(const CaracteristicasSistema &theta,
     fprintf(archivo_salida, "Número promedio en cola: %10.3f\n", num_promedio_cola);
     fprintf(archivo_salida, "Utilización del servidor: %15.3f\n", utilizacion_servidor);
     fprintf(archivo_salida, "Tiempo total de simulación: %12.3f minutos\n", T.tiempo_simulacion);
-    fprintf(archivo_salida, "Total de clientes atendidos: %d\n", theta.num_clientes_espera);
+    fprintf(archivo_salida, "Total de clientes atendidos: %lld\n", theta.num_clientes_espera);
+
+    // θ ← ⟨CalculoFinalPorVentana⟩
+    if (xi.perfil)
+    {
+        const PerfilTasas &perfil = *xi.perfil;
+        fprintf(archivo_salida, "\n==== ESTADÍSTICAS POR VENTANA ====\n");
+        fprintf(archivo_salida, "%10s %10s %10s %10s %10s %10s\n",
+                "Inicio", "Fin", "Llegadas", "Tasa obs.", "Espera", "En cola");
+        for (int v = 0; v + 1 < perfil.num_puntos; ++v)
+        {
+            real_sim tiempo = theta.tiempo_observado_ventana[v];
+            long long clientes = theta.clientes_espera_ventana[v];
+            fprintf(archivo_salida, "%10.3f %10.3f %10lld %10.3f %10.3f %10.3f\n",
+                    perfil.tiempo[v], perfil.tiempo[v + 1], theta.llegadas_ventana[v],
+                    tiempo > 0.0 ? theta.llegadas_ventana[v] / tiempo : 0.0,
+                    clientes > 0 ? theta.total_de_esperas_ventana[v] / clientes : 0.0,
+                    tiempo > 0.0 ? theta.area_num_entra_cola_ventana[v] / tiempo : 0.0);
+        }
+    }
+
+    // θ ← ⟨CalculoFinalPorClase⟩
+    if (xi.clases)
+    {
+        const ClasesClientes &clases = *xi.clases;
+        fprintf(archivo_salida, "\n==== ESTADÍSTICAS POR CLASE (%s) ====\n",
+                clases.apropiativa ? "apropiativa" : "no apropiativa");
+        fprintf(archivo_salida, "%6s %10s %10s %10s %10s %10s %10s %10s\n", "Clase", "Llegada",
+                "Atención", "Llegadas", "Atendidos", "Interrup.", "Espera", "En cola");
+        for (int c = 0; c < clases.num_clases; ++c)
+        {
+            long long clientes = theta.clientes_espera_clase[c];
+            fprintf(archivo_salida, "%6d %10.3f %10.3f %10lld %10lld %10lld %10.3f %10.3f\n", c,
+                    clases.media_entre_llegadas[c], clases.media_atencion[c],
+                    theta.llegadas_clase[c], clientes, theta.interrupciones_clase[c],
+                    clientes > 0 ? theta.total_de_esperas_clase[c] / clientes : 0.0,
+                    theta.area_num_entra_cola_clase[c] / T.tiempo_simulacion);
+        }
+
+        // La derivada por trayectoria no es válida cuando las clases se reordenan
+        fprintf(archivo_salida, "\n==== GRADIENTES IPA: omitidos con varias clases ====\n");
+        return;
+    }
+
+    // ∂θ ← ⟨CalculoFinalDeGradientes⟩
+    const char *nombres[NUM_PARAMETROS_IPA] = {"media_entre_llegadas", "media_atencion"};
+    real_sim d_espera[NUM_PARAMETROS_IPA], d_num_cola[NUM_PARAMETROS_IPA];
+    float d_espera_mm1[NUM_PARAMETROS_IPA], d_num_cola_mm1[NUM_PARAMETROS_IPA];
+    ModuloGradientes::estimarGradientes(theta, T, dtheta, d_espera, d_num_cola);
+    ModuloGradientes::gradientesAnaliticosMM1(xi, d_espera_mm1, d_num_cola_mm1);
+
+    if (xi.perfil)
+    {
+        fprintf(archivo_salida, "\n==== GRADIENTES IPA (llegadas del perfil: sin referencia M/M/1) ====\n");
+    }
+    else
+    {
+        fprintf(archivo_salida, "\n==== GRADIENTES IPA (analítico M/M/1 entre paréntesis) ====\n");
+    }
+    for (int p = 0; p < NUM_PARAMETROS_IPA; ++p)
+    {
+        // Con perfil las llegadas no dependen de media_entre_llegadas: la derivada sería 0
+        if (xi.perfil && p == PARAM_ENTRE_LLEGADAS)
+        {
+            continue;
+        }
+        if (xi.perfil)
+        {
+            fprintf(archivo_salida, "d(Espera promedio)/d(%s): %11.4f\n", nombres[p], d_espera[p]);
+            fprintf(archivo_salida, "d(Número promedio en cola)/d(%s): %11.4f\n", nombres[p], d_num_cola[p]);
+        }
+        else
+        {
+            fprintf(archivo_salida, "d(Espera promedio)/d(%s): %11.4f (%11.4f)\n",
+                    nombres[p], d_espera[p], d_espera_mm1[p]);
+            fprintf(archivo_salida, "d(Número promedio en cola)/d(%s): %11.4f (%11.4f)\n",
+                    nombres[p], d_num_cola[p], d_num_cola_mm1[p]);
+        }
+    }
+}
+
+/* ========== IMPLEMENTACIÓN MÓDULO 7: GRADIENTES IPA ========== */
+void ModuloGradientes::programarEvento(DerivadasIPA &dtheta, int evento, int parametro,
+                                       real_sim muestra, real_sim media)
+{
+    // ∂L[evento] ← ∂T + ∂muestra; para x = -media·ln(u), ∂x/∂media = x/media
+    for (int p = 0; p < NUM_PARAMETROS_IPA; ++p)
+    {
+        dtheta.d_tiempo_sig_evento[evento][p] = dtheta.d_tiempo_simulacion[p];
+    }
+    dtheta.d_tiempo_sig_evento[evento][parametro] += muestra / media;
+}
+
+void ModuloGradientes::gradientesAnaliticosMM1(const ParametrosSistema &xi,
+                                               float d_espera[NUM_PARAMETROS_IPA],
+                                               float d_num_cola[NUM_PARAMETROS_IPA])
+{
+    // Wq = s²/(a - s),  Lq = s²/(a(a - s)),  con a = media_entre_llegadas, s = media_atencion
+    float a = xi.media_entre_llegadas;
+    float s = xi.media_atencion;
+    float holgura = a - s;
+
+    if (holgura <= 0.0)
+    {
+        // Sistema inestable (ρ ≥ 1): no existe estado estacionario
+        for (int p = 0; p < NUM_PARAMETROS_IPA; ++p)
+        {
+            d_espera[p] = NAN;
+            d_num_cola[p] = NAN;
+        }
+        return;
+    }
+
+    d_espera[PARAM_ENTRE_LLEGADAS] = -s * s / (holgura * holgura);
+    d_espera[PARAM_ATENCION] = s * (2.0 * a - s) / (holgura * holgura);
+    d_num_cola[PARAM_ENTRE_LLEGADAS] = -s * s * (2.0 * a - s) / (a * a * holgura * holgura);
+    d_num_cola[PARAM_ATENCION] = s * (2.0 * a - s) / (a * holgura * holgura);
+}
+
+void ModuloGradientes::estimarGradientes(const CaracteristicasSistema &theta, const TiempoEspacio &T,
+                                         const DerivadasIPA &dtheta,
+                                         real_sim d_espera[NUM_PARAMETROS_IPA],
+                                         real_sim d_num_cola[NUM_PARAMETROS_IPA])
+{
+    // Wq = total/n, Lq = área/T  ⇒  ∂Wq = ∂total/n,  ∂Lq = ∂área/T - área·∂T/T²
+    for (int p = 0; p < NUM_PARAMETROS_IPA; ++p)
+    {
+        d_espera[p] = dtheta.d_total_de_esperas[p] / theta.num_clientes_espera;
+        d_num_cola[p] = dtheta.d_area_num_entra_cola[p] / T.tiempo_simulacion -
+                        ModuloPrecision::valor(theta.area_num_entra_cola) * dtheta.d_tiempo_simulacion[p] /
+                            (T.tiempo_simulacion * T.tiempo_simulacion);
+    }
+}
+
+/* ========== IMPLEMENTACIÓN MÓDULO 8: CACHÉ DE RESULTADOS ========== */
+static unsigned long long mezclarBytes(unsigned long long h, const void *datos, size_t n)
+{
+    // FNV-1a de 64 bits
+    const unsigned char *bytes = (const unsigned char *)datos;
+    for (size_t i = 0; i < n; ++i)
+    {
+        h ^= bytes[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static bool coincideEscenario(const EntradaCache &entrada, unsigned long long clave,
+                              const ParametrosSistema &xi, const EstadoAleatorio &estado_inicial)
+{
+    return entrada.clave == clave &&
+           entrada.version_motor == VERSION_MOTOR &&
+           entrada.flujo_aleatorio == FLUJO_ALEATORIO &&
+           memcmp(&entrada.estado_inicial, &estado_inicial, sizeof(estado_inicial)) == 0 &&
+           entrada.media_entre_llegadas == xi.media_entre_llegadas &&
+           entrada.media_atencion == xi.media_atencion &&
+           entrada.num_esperas_requerido == xi.num_esperas_requerido;
+}
+
+unsigned long long ModuloCache::calcularClave(const ParametrosSistema &xi,
+                                              const EstadoAleatorio &estado_inicial)
+{
+    // clave ← H(versión, flujo, estado del generador, parámetros, regla de parada, precisión, registro, perfil, clases)
+    int version_motor = VERSION_MOTOR;
+    int flujo_aleatorio = FLUJO_ALEATORIO;
+    int precision = (int)sizeof(real_sim);
+    int tamano_entrada = (int)sizeof(EntradaCache);
+    unsigned long long h = 14695981039346656037ULL;
+
+    h = mezclarBytes(h, &version_motor, sizeof(version_motor));
+    h = mezclarBytes(h, &flujo_aleatorio, sizeof(flujo_aleatorio));
+    h = mezclarBytes(h, &estado_inicial, sizeof(estado_inicial));
+    h = mezclarBytes(h, &xi.media_entre_llegadas, sizeof(xi.media_entre_llegadas));
+    h = mezclarBytes(h, &xi.media_atencion, sizeof(xi.media_atencion));
+    h = mezclarBytes(h, &xi.num_esperas_requerido, sizeof(xi.num_esperas_requerido));
+    h = mezclarBytes(h, &precision, sizeof(precision));
+    h = mezclarBytes(h, &tamano_entrada, sizeof(tamano_entrada));
+    if (xi.perfil)
+    {
+        const PerfilTasas &perfil = *xi.perfil;
+        h = mezclarBytes(h, &perfil.modo, sizeof(perfil.modo));
+        h = mezclarBytes(h, &perfil.num_puntos, sizeof(perfil.num_puntos));
+        h = mezclarBytes(h, perfil.tiempo, perfil.num_puntos * sizeof(double));
+        h = mezclarBytes(h, perfil.tasa, perfil.num_puntos * sizeof(double));
+    }
+    if (xi.clases)
+    {
+        const ClasesClientes &clases = *xi.clases;
+        h = mezclarBytes(h, &clases.num_clases, sizeof(clases.num_clases));
+        h = mezclarBytes(h, &clases.apropiativa, sizeof(clases.apropiativa));
+        h = mezclarBytes(h, clases.media_entre_llegadas, clases.num_clases * sizeof(float));
+        h = mezclarBytes(h, clases.media_atencion, clases.num_clases * sizeof(float));
+    }
+    return h;
+}
+
+static void encabezadoEsperado(EncabezadoCache &encabezado)
+{
+    memset(&encabezado, 0, sizeof(encabezado));
+    memcpy(encabezado.firma, "SCCACHE", 8);
+    encabezado.formato = FORMATO_CACHE;
+    encabezado.tamano_entrada = (int)sizeof(EntradaCache);
+    encabezado.num_cubetas = CUBETAS_CACHE;
+}
+
+// Posicionamiento de 64 bits: el archivo de datos pasa de 2 GB con unos 400 mil registros
+static int irA(FILE *archivo, long long posicion, int origen)
+{
+#ifdef _WIN32
+    return _fseeki64(archivo, posicion, origen);
+#else
+    return fseeko(archivo, (off_t)posicion, origen);
+#endif
+}
+
+static long long posicionActual(FILE *archivo)
+{
+#ifdef _WIN32
+    return _ftelli64(archivo);
+#else
+    return (long long)ftello(archivo);
+#endif
+}
+
+static long long tamanoArchivo(FILE *archivo)
+{
+    irA(archivo, 0, SEEK_END);
+    return posicionActual(archivo);
+}
+
+// Abre para lectura y escritura, creándolo si no existe pero sin truncarlo
+static FILE *abrirSinTruncar(const char *nombre_archivo)
+{
+#ifdef _WIN32
+    int descriptor = _open(nombre_archivo, _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+    return (descriptor >= 0) ? _fdopen(descriptor, "r+b") : NULL;
+#else
+    int descriptor = open(nombre_archivo, O_RDWR | O_CREAT, 0644);
+    return (descriptor >= 0) ? fdopen(descriptor, "r+b") : NULL;
+#endif
+}
+
+static void vaciarArchivo(FILE *archivo)
+{
+    fflush(archivo);
+#ifdef _WIN32
+    _chsize_s(_fileno(archivo), 0);
+#else
+    if (ftruncate(fileno(archivo), 0) != 0)
+    {
+        fprintf(stderr, "Advertencia: no se pudo vaciar el caché\n");
+    }
+#endif
+}
+
+// Bloqueo del índice entre procesos: compartido para buscar, exclusivo para agregar
+static void bloquearArchivo(FILE *archivo, bool exclusivo)
+{
+#ifdef _WIN32
+    OVERLAPPED solapado;
+    memset(&solapado, 0, sizeof(solapado));
+    LockFileEx((HANDLE)_get_osfhandle(_fileno(archivo)), exclusivo ? LOCKFILE_EXCLUSIVE_LOCK : 0,
+               0, MAXDWORD, MAXDWORD, &solapado);
+#else
+    while (flock(fileno(archivo), exclusivo ? LOCK_EX : LOCK_SH) != 0 && errno == EINTR)
+    {
+    }
+#endif
+}
+
+static void desbloquearArchivo(FILE *archivo)
+{
+    fflush(archivo);
+#ifdef _WIN32
+    OVERLAPPED solapado;
+    memset(&solapado, 0, sizeof(solapado));
+    UnlockFileEx((HANDLE)_get_osfhandle(_fileno(archivo)), 0, MAXDWORD, MAXDWORD, &solapado);
+#else
+    flock(fileno(archivo), LOCK_UN);
+#endif
+}
+
+static bool encabezadoValido(FILE *archivo)
+{
+    EncabezadoCache esperado, leido;
+    encabezadoEsperado(esperado);
+    return archivo && irA(archivo, 0, SEEK_SET) == 0 &&
+           fread(&leido, sizeof(leido), 1, archivo) == 1 &&
+           memcmp(&leido, &esperado, sizeof(leido)) == 0;
+}
+
+static void nombreIndice(const char *nombre_archivo, char *destino, size_t tamano)
+{
+    snprintf(destino, tamano, "%s.idx", nombre_archivo);
+}
+
+// Posiciones dentro del índice: encabezado, cubetas y luego los nodos
+static long long posicionCubeta(long long cubeta)
+{
+    return (long long)sizeof(EncabezadoCache) + cubeta * (long long)sizeof(long long);
+}
+
+static long long posicionNodo(long long nodo)
+{
+    return posicionCubeta(CUBETAS_CACHE) + (nodo - 1) * (long long)sizeof(NodoIndiceCache);
+}
+
+bool ModuloCache::buscar(const char *nombre_archivo, const ParametrosSistema &xi,
+                         const EstadoAleatorio &estado_inicial, EntradaCache &entrada)
+{
+    unsigned long long clave = calcularClave(xi, estado_inicial);
+    char nombre_indice[1024];
+    nombreIndice(nombre_archivo, nombre_indice, sizeof(nombre_indice));
+
+    FILE *indice = fopen(nombre_indice, "rb");
+    if (!indice)
+    {
+        return false;
+    }
+
+    // Con el bloqueo compartido ningún proceso está agregando ni reiniciando el caché
+    bloquearArchivo(indice, false);
+    FILE *datos = fopen(nombre_archivo, "rb");
+    bool encontrado = false;
+
+    // Un caché de otra versión o de otro tamaño de registro no se lee
+    if (encabezadoValido(datos) && encabezadoValido(indice))
+    {
+#ifndef _WIN32
+        // El índice se mapea completo; sólo se tocan la cubeta y su cadena
+        struct stat info;
+        fstat(fileno(indice), &info);
+        size_t tamano = (size_t)info.st_size;
+        void *mapa = (tamano >= (size_t)posicionNodo(1))
+                         ? mmap(NULL, tamano, PROT_READ, MAP_SHARED, fileno(indice), 0)
+                         : MAP_FAILED;
+        if (mapa != MAP_FAILED)
+        {
+            const char *base = (const char *)mapa;
+            long long nodo;
+            memcpy(&nodo, base + posicionCubeta(clave % CUBETAS_CACHE), sizeof(nodo));
+
+            while (nodo > 0 && !encontrado && posicionNodo(nodo + 1) <= (long long)tamano)
+            {
+                NodoIndiceCache leido;
+                memcpy(&leido, base + posicionNodo(nodo), sizeof(leido));
+                if (leido.clave == clave &&
+                    irA(datos, leido.desplazamiento, SEEK_SET) == 0 &&
+                    fread(&entrada, sizeof(EntradaCache), 1, datos) == 1 &&
+                    coincideEscenario(entrada, clave, xi, estado_inicial))
+                {
+                    encontrado = true;
+                }
+                nodo = leido.siguiente;
+            }
+            munmap(mapa, tamano);
+        }
+#else
+        long long nodo = 0;
+        irA(indice, posicionCubeta(clave % CUBETAS_CACHE), SEEK_SET);
+        if (fread(&nodo, sizeof(nodo), 1, indice) != 1)
+        {
+            nodo = 0;
+        }
+
+        while (nodo > 0 && !encontrado)
+        {
+            NodoIndiceCache leido;
+            if (irA(indice, posicionNodo(nodo), SEEK_SET) != 0 ||
+                fread(&leido, sizeof(leido), 1, indice) != 1)
+            {
+                break;
+            }
+            if (leido.clave == clave &&
+                irA(datos, leido.desplazamiento, SEEK_SET) == 0 &&
+                fread(&entrada, sizeof(EntradaCache), 1, datos) == 1 &&
+                coincideEscenario(entrada, clave, xi, estado_inicial))
+            {
+                encontrado = true;
+            }
+            nodo = leido.siguiente;
+        }
+#endif
+    }
+
+    if (datos)
+    {
+        fclose(datos);
+    }
+    desbloquearArchivo(indice);
+    fclose(indice);
+    return encontrado;
+}
+
+void ModuloCache::guardar(const char *nombre_archivo, const EntradaCache &entrada)
+{
+    char nombre_indice[1024];
+    nombreIndice(nombre_archivo, nombre_indice, sizeof(nombre_indice));
+
+    FILE *indice = abrirSinTruncar(nombre_indice);
+    FILE *datos = abrirSinTruncar(nombre_archivo);
+    if (!datos || !indice)
+    {
+        fprintf(stderr, "Advertencia: no se pudo escribir el caché: %s\n", nombre_archivo);
+        if (datos)
+        {
+            fclose(datos);
+        }
+        if (indice)
+        {
+            fclose(indice);
+        }
+        return;
+    }
+
+    // Todo el agregado ocurre con el índice bloqueado: dos procesos de un mismo lote
+    // leerían la misma cubeta y se pisarían el nodo y el puntero
+    bloquearArchivo(indice, true);
+
+    // Si un archivo está vacío o no coincide el encabezado, el caché empieza de nuevo
+    if (!encabezadoValido(datos) || !encabezadoValido(indice))
+    {
+        if (tamanoArchivo(datos) > 0 || tamanoArchivo(indice) > 0)
+        {
+            fprintf(stderr, "Advertencia: caché incompatible o incompleto, se reinicia: %s\n",
+                    nombre_archivo);
+        }
+        vaciarArchivo(datos);
+        vaciarArchivo(indice);
+
+        EncabezadoCache encabezado;
+        encabezadoEsperado(encabezado);
+        irA(datos, 0, SEEK_SET);
+        fwrite(&encabezado, sizeof(encabezado), 1, datos);
+        irA(indice, 0, SEEK_SET);
+        fwrite(&encabezado, sizeof(encabezado), 1, indice);
+
+        // Cubetas vacías: escribir el último byte deja el resto en cero
+        irA(indice, posicionNodo(1) - 1, SEEK_SET);
+        fputc(0, indice);
+    }
+
+    // Los datos y los nodos sólo se agregan al final; la cubeta pasa a apuntar al nodo
+    // nuevo cuando el registro y el nodo ya están escritos
+    long long cubeta = (long long)(entrada.clave % CUBETAS_CACHE);
+    NodoIndiceCache nodo;
+    nodo.clave = entrada.clave;
+    nodo.siguiente = 0;
+
+    irA(datos, 0, SEEK_END);
+    nodo.desplazamiento = posicionActual(datos);
+    fwrite(&entrada, sizeof(EntradaCache), 1, datos);
+    fflush(datos);
+
+    irA(indice, posicionCubeta(cubeta), SEEK_SET);
+    if (fread(&nodo.siguiente, sizeof(nodo.siguiente), 1, indice) != 1)
+    {
+        nodo.siguiente = 0;
+    }
+    irA(indice, 0, SEEK_END);
+    long long nuevo = (posicionActual(indice) - posicionNodo(1)) / (long long)sizeof(NodoIndiceCache) + 1;
+    fwrite(&nodo, sizeof(nodo), 1, indice);
+    fflush(indice);
+
+    irA(indice, posicionCubeta(cubeta), SEEK_SET);
+    fwrite(&nuevo, sizeof(nuevo), 1, indice);
+
+    desbloquearArchivo(indice);
+    fclose(datos);
+    fclose(indice);
 }
 
 /* ========== IMPLEMENTACIÓN MÓDULO 6: REGISTRO DE EVENTOS ========== */
@@ -243,7 +1416,7 @@ void ModuloRegistro::escribirEventoCliente(const DatosCliente &cliente, FILE *ar
 {
     if (archivo && cliente.numero > 0)
     {
-        fprintf(archivo, "%d,%.6f,%.6f\n", 
+        fprintf(archivo, "%lld,%.6f,%.6f\n", 
                 cliente.numero,
                 cliente.tiempo_entre_llegadas * 60.0, // Convertir minutos a segundos
                 cliente.tiempo_atencion * 60.0);      // Convertir minutos a segundos
@@ -263,10 +1436,14 @@ void ModuloRegistro::finalizarRegistro(RegistroEventos &registro)
 /* ========== IMPLEMENTACIÓN PROCEDIMIENTO PRINCIPAL ========== */
 void SimuladorPrincipal::ejecutarSimulacion(const char *archivo_parametros,
                                             const char *archivo_resultados,
-                                            const char *archivo_log)
+                                            const char *archivo_log,
+                                            const char *archivo_cache,
+                                            const char *archivo_perfil,
+                                            const char *archivo_clases)
 {
     FILE *parametros, *resultados;
     RegistroEventos registro;
+    EntradaCache entrada;
 
     // Abrir archivos
     parametros = fopen(archivo_parametros, "r");
@@ -278,59 +1455,180 @@ void SimuladorPrincipal::ejecutarSimulacion(const char *archivo_parametros,
         exit(1);
     }
 
-    // Inicializar sistema de registro
-    ModuloRegistro::inicializarRegistro(registro, archivo_log);
-
     // Leer parámetros
-    fscanf(parametros, "%f %f %d", &xi.media_entre_llegadas,
+    fscanf(parametros, "%f %f %lld", &xi.media_entre_llegadas,
            &xi.media_atencion, &xi.num_esperas_requerido);
     xi.num_eventos = 2;
 
+    // Leer el perfil de tasas si existe; si no, las llegadas son homogéneas
+    xi.perfil = NULL;
+    FILE *archivo_tasas = archivo_perfil ? fopen(archivo_perfil, "r") : NULL;
+    if (archivo_tasas)
+    {
+        if (!ModuloPerfil::cargarPerfil(perfil, archivo_tasas))
+        {
+            fprintf(stderr, "Error al leer el perfil de tasas: %s\n", archivo_perfil);
+            exit(1);
+        }
+        xi.perfil = &perfil;
+        fclose(archivo_tasas);
+    }
+
+    // Leer las clases de clientes si existen; si no, hay una sola clase FIFO
+    xi.clases = NULL;
+    FILE *archivo_prioridades = archivo_clases ? fopen(archivo_clases, "r") : NULL;
+    if (archivo_prioridades)
+    {
+        if (!ModuloClases::cargarClases(clases, archivo_prioridades))
+        {
+            fprintf(stderr, "Error al leer las clases de clientes: %s\n", archivo_clases);
+            exit(1);
+        }
+        xi.clases = &clases;
+        fclose(archivo_prioridades);
+
+        // Las llegadas de todas las clases forman un solo proceso de Poisson
+        float tasa_total = 0.0, carga_total = 0.0;
+        for (int c = 0; c < clases.num_clases; ++c)
+        {
+            tasa_total += 1.0 / clases.media_entre_llegadas[c];
+            carga_total += clases.media_atencion[c] / clases.media_entre_llegadas[c];
+        }
+        xi.media_entre_llegadas = 1.0 / tasa_total;
+        xi.media_atencion = carga_total / tasa_total;
+    }
+
     // Escribir encabezado
     fprintf(resultados, "Sistema de Colas Simple - Implementación Modular\n\n");
-    fprintf(resultados, "Tiempo promedio de llegada: %11.3f minutos\n", xi.media_entre_llegadas);
+    if (xi.perfil)
+    {
+        fprintf(resultados, "Perfil de tasas de llegada: %s (%s, %d ventanas, periodo %.3f minutos)\n",
+                archivo_perfil, perfil.modo == PERFIL_LINEAL ? "lineal" : "constante",
+                perfil.num_puntos - 1, perfil.tiempo[perfil.num_puntos - 1]);
+    }
+    else
+    {
+        fprintf(resultados, "Tiempo promedio de llegada: %11.3f minutos\n", xi.media_entre_llegadas);
+    }
+    if (xi.clases)
+    {
+        fprintf(resultados, "Clases de clientes: %d (%s, ver %s)\n", clases.num_clases,
+                clases.apropiativa ? "apropiativa" : "no apropiativa", archivo_clases);
+    }
     fprintf(resultados, "Tiempo promedio de atención: %16.3f minutos\n", xi.media_atencion);
-    fprintf(resultados, "Número de clientes objetivo: %14d\n\n", xi.num_esperas_requerido);
+    fprintf(resultados, "Número de clientes objetivo: %14lld\n\n", xi.num_esperas_requerido);
+#ifndef CORRIDA_LARGA
+    if (xi.num_esperas_requerido > MAX_CLIENTES_FLUJO)
+    {
+        fprintf(resultados, "Advertencia: lcgrand repite su secuencia después de unos %lld clientes; "
+                            "compilar con CORRIDA_LARGA\n\n", MAX_CLIENTES_FLUJO);
+    }
+#endif
+
+    // SI el escenario ya fue simulado ENTONCES reutilizar su resultado
+    EstadoAleatorio estado_inicial;
+    ModuloAleatorio::obtenerEstado(estado_inicial);
+    if (archivo_cache && ModuloCache::buscar(archivo_cache, xi, estado_inicial, entrada))
+    {
+        T = entrada.T;
+        theta = entrada.theta;
+        for (int p = 0; p < NUM_PARAMETROS_IPA; ++p)
+        {
+            dtheta.d_tiempo_simulacion[p] = entrada.d_tiempo_simulacion[p];
+            dtheta.d_total_de_esperas[p] = entrada.d_total_de_esperas[p];
+            dtheta.d_area_num_entra_cola[p] = entrada.d_area_num_entra_cola[p];
+        }
+        ModuloAleatorio::fijarEstado(entrada.estado_final);
+
+        // El registro de eventos no se guarda en el caché: se deja sólo el
+        // encabezado para no confundirlo con el de otro escenario
+        ModuloRegistro::inicializarRegistro(registro, archivo_log);
+        ModuloRegistro::finalizarRegistro(registro);
+
+        fprintf(resultados, "Resultado recuperado del caché (clave %016llx); %s queda vacío\n",
+                entrada.clave, archivo_log);
+        ModuloReportes::generarReporte(theta, T, dtheta, xi, resultados);
+
+        fclose(parametros);
+        fclose(resultados);
+        return;
+    }
+
+    // Inicializar sistema de registro
+    ModuloRegistro::inicializarRegistro(registro, archivo_log);
 
     // LLAMAR INICIALIZACIÓN
-    ModuloInicializacion::inicializar(T, X, theta, L, xi);
+    ModuloInicializacion::inicializar(T, X, theta, L, dtheta, xi);
 
     // MIENTRAS (condición no se cumpla) HACER
     while (theta.num_clientes_espera < xi.num_esperas_requerido)
     {
         // LLAMAR ManejoTiempoEspacio
-        int tipo_evento = ModuloManejoTiempo::manejoTiempoEspacio(T, L, xi);
+        int tipo_evento = ModuloManejoTiempo::manejoTiempoEspacio(T, L, dtheta, xi);
 
         // Actualizar estadísticas promedio
-        ModuloEventos::actualizarEstadisticasPromedio(X, theta, T);
+        ModuloEventos::actualizarEstadisticasPromedio(X, theta, T, dtheta, xi);
 
         // SEGÚN (tipo_evento) HACER
         switch (tipo_evento)
         {
         case EVENTO_LLEGADA:
-            ModuloEventos::eventoLlegada(X, theta, L, T, xi, registro);
+            ModuloEventos::eventoLlegada(X, theta, L, T, dtheta, xi, registro);
             break;
         case EVENTO_SALIDA:
-            ModuloEventos::eventoSalida(X, theta, L, T, xi, registro);
+            ModuloEventos::eventoSalida(X, theta, L, T, dtheta, xi, registro);
             break;
         }
     }
 
+    // Cerrar las áreas de las colas por clase en el tiempo final
+    ModuloColas::cerrarAreasClase(X, theta, T);
+
     // LLAMAR GeneradorReporte
-    ModuloReportes::generarReporte(theta, T, xi, resultados);
+    ModuloReportes::generarReporte(theta, T, dtheta, xi, resultados);
 
     // Finalizar registro
     ModuloRegistro::finalizarRegistro(registro);
 
+    // Guardar el resultado en el caché
+    if (archivo_cache)
+    {
+        memset(&entrada, 0, sizeof(entrada));
+        entrada.clave = ModuloCache::calcularClave(xi, estado_inicial);
+        entrada.version_motor = VERSION_MOTOR;
+        entrada.flujo_aleatorio = FLUJO_ALEATORIO;
+        entrada.estado_inicial = estado_inicial;
+        ModuloAleatorio::obtenerEstado(entrada.estado_final);
+        entrada.media_entre_llegadas = xi.media_entre_llegadas;
+        entrada.media_atencion = xi.media_atencion;
+        entrada.num_esperas_requerido = xi.num_esperas_requerido;
+        entrada.T = T;
+        entrada.theta = theta;
+        for (int p = 0; p < NUM_PARAMETROS_IPA; ++p)
+        {
+            entrada.d_tiempo_simulacion[p] = dtheta.d_tiempo_simulacion[p];
+            entrada.d_total_de_esperas[p] = dtheta.d_total_de_esperas[p];
+            entrada.d_area_num_entra_cola[p] = dtheta.d_area_num_entra_cola[p];
+        }
+        ModuloCache::guardar(archivo_cache, entrada);
+    }
+
     // Cerrar archivos
     fclose(parametros);
     fclose(resultados);
 }
 
 /* Función main para usar la clase */
+#ifndef SIN_MAIN
 int main()
 {
     SimuladorPrincipal simulador;
+#ifdef USAR_CACHE
+    // Con caché, un escenario ya simulado deja eventos_clientes.csv sólo con el encabezado
+    simulador.ejecutarSimulacion("param.txt", "result.txt", "eventos_clientes.csv", ARCHIVO_CACHE);
+#else
     simulador.ejecutarSimulacion("param.txt", "result.txt", "eventos_clientes.csv");
+#endif
     return 0;
-}
\ No newline at end of file
+}
+#endif // SIN_MAIN
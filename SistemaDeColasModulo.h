@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 
 /* ========== CONSTANTES ========== */
 #define LIMITE_COLA 100
@@ -11,103 +12,304 @@
 #define OCUPADO 1
 #define EVENTO_LLEGADA 1
 #define EVENTO_SALIDA 2
+#define PARAM_ENTRE_LLEGADAS 0
+#define PARAM_ATENCION 1
+#define NUM_PARAMETROS_IPA 2
+#define VERSION_MOTOR 5 // Incrementar cuando cambien los resultados o el formato del caché
+#define FLUJO_ALEATORIO 1 // Flujo de lcgrand usado por la simulación
+#define MAX_VENTANAS 96 // Segmentos del perfil de tasas (p. ej. 15 minutos en un día)
+#define PERFIL_CONSTANTE 0
+#define PERFIL_LINEAL 1
+#define MAX_CLASES 64 // Una clase por bit del mapa de colas no vacías
+#define FORMATO_CACHE 1 // Incrementar cuando cambie la estructura de los archivos del caché
+#define CUBETAS_CACHE (1 << 20) // Cubetas del índice hash del caché
+
+/* ========== PRECISIÓN ========== */
+// Con CORRIDA_LARGA el reloj y los acumuladores son double, los acumuladores
+// principales usan suma compensada (Neumaier) y las uniformes salen de MRG32k3a
+// (periodo ~2^191); sin ella se conserva float y lcgrand, cuyo periodo de
+// 2^31 - 2 alcanza para unos 10^9 clientes (dos uniformes por cliente)
+#ifdef CORRIDA_LARGA
+typedef double real_sim;
+#define ARCHIVO_CACHE "cache_resultados_larga.bin"
+#else
+typedef float real_sim;
+#define ARCHIVO_CACHE "cache_resultados.bin"
+#define MAX_CLIENTES_FLUJO 1073741823LL // (2^31 - 2) / 2
+#endif
 
 /* ========== ESTRUCTURAS DE DATOS ========== */
 
+// Estructura para un acumulador de sumas largas
+struct Acumulador {
+    real_sim suma;
+    real_sim compensacion; // Error de redondeo acumulado (sólo con CORRIDA_LARGA)
+};
+
+// Estructura para el estado del generador de uniformes de la simulación
+struct EstadoAleatorio {
+#ifdef CORRIDA_LARGA
+    double s1[3]; // Componente módulo m1 de MRG32k3a
+    double s2[3]; // Componente módulo m2 de MRG32k3a
+#else
+    long z; // zrng[FLUJO_ALEATORIO] de lcgrand
+#endif
+};
+
+// Estructura para el perfil de tasas de llegada no homogéneo (periódico)
+// Los puntos van de tiempo[0] = 0 hasta tiempo[num_puntos - 1] = periodo
+struct PerfilTasas {
+    int modo; // PERFIL_CONSTANTE o PERFIL_LINEAL
+    int num_puntos;
+    double tiempo[MAX_VENTANAS + 1];
+    double tasa[MAX_VENTANAS + 1];      // Clientes por minuto
+    double acumulada[MAX_VENTANAS + 1]; // Λ(tiempo[i]) dentro del periodo
+};
+
+// Estructura para las clases de clientes con prioridad (0 es la más alta)
+// La clase de cada llegada se elige con el método de alias en O(1)
+struct ClasesClientes {
+    int num_clases;
+    int apropiativa; // 1: la llegada de mayor prioridad interrumpe la atención
+    float media_entre_llegadas[MAX_CLASES];
+    float media_atencion[MAX_CLASES];
+    float prob_alias[MAX_CLASES];
+    int alias[MAX_CLASES];
+};
+
 // Estructura para los parámetros del sistema
 struct ParametrosSistema {
     float media_entre_llegadas;
     float media_atencion;
-    int num_esperas_requerido;
+    long long num_esperas_requerido;
     int num_eventos;
+    const PerfilTasas *perfil; // NULL: llegadas homogéneas con media_entre_llegadas
+    const ClasesClientes *clases; // NULL: una sola clase FIFO
 };
 
 // Estructura para tiempo y espacio
 struct TiempoEspacio {
-    float tiempo_simulacion;
-    float tiempo_ultimo_evento;
+    real_sim tiempo_simulacion;
+    real_sim tiempo_ultimo_evento;
 };
 
 // Estructura para el estado del sistema
+// Los clientes en cola ocupan espacios 1..LIMITE_COLA; cada clase guarda sus
+// espacios en una cola circular y el bit c de clases_no_vacias indica si la
+// cola de la clase c tiene clientes
 struct EstadoSistema {
     int estado_servidor;
     int num_entra_cola;
-    float tiempo_llegada[LIMITE_COLA + 1];
+    int clase_en_servicio;
+    real_sim llegada_en_servicio;                // Llegada al sistema del cliente en servicio
+    real_sim tiempo_llegada[LIMITE_COLA + 1];    // Último ingreso a la cola, por espacio
+    real_sim llegada_original[LIMITE_COLA + 1];  // Llegada al sistema, por espacio; no cambia al interrumpir
+    int clase_cliente[LIMITE_COLA + 1];          // Por espacio
+    real_sim atencion_restante[LIMITE_COLA + 1]; // Por espacio; < 0 si aún no fue atendido
+    int cola_clase[MAX_CLASES][LIMITE_COLA];
+    int inicio_cola[MAX_CLASES];
+    int tamano_cola[MAX_CLASES];
+    unsigned long long clases_no_vacias;
+    int espacios_libres[LIMITE_COLA];
+    int num_espacios_libres;
 };
 
 // Estructura para las características del sistema
 struct CaracteristicasSistema {
-    int num_clientes_espera;
-    float total_de_esperas;
-    float area_num_entra_cola;
-    float area_estado_servidor;
+    long long num_clientes_espera;
+    Acumulador total_de_esperas;
+    Acumulador area_num_entra_cola;
+    Acumulador area_estado_servidor;
+
+    // Estadísticas por ventana del perfil de tasas (sólo con perfil)
+    long long llegadas_ventana[MAX_VENTANAS];
+    long long clientes_espera_ventana[MAX_VENTANAS];
+    real_sim total_de_esperas_ventana[MAX_VENTANAS];
+    real_sim area_num_entra_cola_ventana[MAX_VENTANAS];
+    real_sim tiempo_observado_ventana[MAX_VENTANAS];
+
+    // Estadísticas por clase (sólo con clases); el área de cada cola se
+    // acumula cuando cambia su tamaño
+    long long llegadas_clase[MAX_CLASES];
+    long long clientes_espera_clase[MAX_CLASES];
+    long long interrupciones_clase[MAX_CLASES];
+    real_sim total_de_esperas_clase[MAX_CLASES];
+    real_sim area_num_entra_cola_clase[MAX_CLASES];
+    real_sim tiempo_ultimo_cambio_clase[MAX_CLASES];
+};
+
+// Estructura para los acumuladores de análisis de perturbación infinitesimal (IPA)
+// Cada arreglo guarda la derivada respecto a media_entre_llegadas [PARAM_ENTRE_LLEGADAS]
+// y respecto a media_atencion [PARAM_ATENCION]
+struct DerivadasIPA {
+    real_sim d_tiempo_simulacion[NUM_PARAMETROS_IPA];
+    real_sim d_tiempo_ultimo_evento[NUM_PARAMETROS_IPA];
+    real_sim d_tiempo_sig_evento[3][NUM_PARAMETROS_IPA];
+    real_sim d_tiempo_llegada[LIMITE_COLA + 1][NUM_PARAMETROS_IPA];
+    real_sim d_total_de_esperas[NUM_PARAMETROS_IPA];
+    real_sim d_area_num_entra_cola[NUM_PARAMETROS_IPA];
 };
 
 // Estructura para la lista de eventos
 struct ListaEventos {
-    float tiempo_sig_evento[3]; // Índices 1 y 2 para llegada y salida
+    real_sim tiempo_sig_evento[3]; // Índices 1 y 2 para llegada y salida
 };
 
 // Estructura para datos de cada cliente (para logging)
 struct DatosCliente {
-    int numero;
-    float tiempo_entre_llegadas;
-    float tiempo_atencion;
-    float tiempo_llegada;
+    long long numero;
+    real_sim tiempo_entre_llegadas;
+    real_sim tiempo_atencion;
+    real_sim tiempo_llegada;
 };
 
 // Estructura para el registro de eventos
 struct RegistroEventos {
     FILE *archivo_log;
-    int numero_cliente;
-    float ultimo_tiempo_llegada;
+    long long numero_cliente;
+    real_sim ultimo_tiempo_llegada;
     DatosCliente cliente_en_servicio;
     DatosCliente clientes_en_cola[LIMITE_COLA + 1];
 };
 
+// Estructura para cada entrada del caché de resultados (registro de tamaño fijo)
+struct EntradaCache {
+    unsigned long long clave;
+    int version_motor;
+    int flujo_aleatorio;
+    EstadoAleatorio estado_inicial;
+    EstadoAleatorio estado_final;
+    // Sólo los parámetros escalares; el perfil y las clases entran en la clave
+    float media_entre_llegadas;
+    float media_atencion;
+    long long num_esperas_requerido;
+    TiempoEspacio T;
+    CaracteristicasSistema theta;
+    real_sim d_tiempo_simulacion[NUM_PARAMETROS_IPA];
+    real_sim d_total_de_esperas[NUM_PARAMETROS_IPA];
+    real_sim d_area_num_entra_cola[NUM_PARAMETROS_IPA];
+};
+
+// Encabezado de los archivos del caché (datos e índice); si no coincide con
+// este ejecutable, el caché se descarta
+struct EncabezadoCache {
+    char firma[8];
+    int formato;
+    int tamano_entrada; // sizeof(EntradaCache)
+    long long num_cubetas;
+};
+
+// Nodo del índice del caché: las cubetas guardan el último nodo agregado
+// (1..n, 0 si está vacía) y cada nodo apunta al anterior de su cubeta
+struct NodoIndiceCache {
+    unsigned long long clave;
+    long long desplazamiento; // Posición de la EntradaCache en el archivo de datos
+    long long siguiente;
+};
+
 /* ========== MÓDULOS ========== */
 
 class ModuloInicializacion {
 public:
     static void inicializar(TiempoEspacio &T, EstadoSistema &X,
                            CaracteristicasSistema &theta, ListaEventos &L,
-                           const ParametrosSistema &xi);
+                           DerivadasIPA &dtheta, const ParametrosSistema &xi);
 };
 
 class ModuloManejoTiempo {
 public:
     static int manejoTiempoEspacio(TiempoEspacio &T, ListaEventos &L,
-                                  const ParametrosSistema &xi);
+                                  DerivadasIPA &dtheta, const ParametrosSistema &xi);
 };
 
 class ModuloEventos {
 public:
     static void eventoLlegada(EstadoSistema &X, CaracteristicasSistema &theta,
                              ListaEventos &L, const TiempoEspacio &T,
-                             const ParametrosSistema &xi, RegistroEventos &registro);
+                             DerivadasIPA &dtheta, const ParametrosSistema &xi,
+                             RegistroEventos &registro);
     
     static void eventoSalida(EstadoSistema &X, CaracteristicasSistema &theta,
                             ListaEventos &L, const TiempoEspacio &T,
-                            const ParametrosSistema &xi, RegistroEventos &registro);
+                            DerivadasIPA &dtheta, const ParametrosSistema &xi,
+                            RegistroEventos &registro);
     
     static void actualizarEstadisticasPromedio(const EstadoSistema &X,
                                               CaracteristicasSistema &theta,
-                                              TiempoEspacio &T);
+                                              TiempoEspacio &T,
+                                              DerivadasIPA &dtheta,
+                                              const ParametrosSistema &xi);
 };
 
 class ModuloPercentil {
 public:
-    static float percentilExponencial(float media);
+    static real_sim percentilExponencial(real_sim media);
+    static real_sim percentilLlegadaNoHomogenea(const PerfilTasas &perfil, double tiempo_actual);
+    static real_sim percentilEntreLlegadas(const ParametrosSistema &xi, double tiempo_actual);
+};
+
+class ModuloPrecision {
+public:
+    static void reiniciar(Acumulador &acumulador);
+    static void sumar(Acumulador &acumulador, real_sim valor);
+    static real_sim valor(const Acumulador &acumulador);
+};
+
+class ModuloAleatorio {
+public:
+    static double uniforme();
+    static void obtenerEstado(EstadoAleatorio &estado);
+    static void fijarEstado(const EstadoAleatorio &estado);
+};
+
+class ModuloColas {
+public:
+    static void inicializarColas(EstadoSistema &X);
+    static int encolar(EstadoSistema &X, int clase, bool al_frente);
+    static int claseMayorPrioridad(const EstadoSistema &X);
+    static int desencolar(EstadoSistema &X, int clase);
+    static void acumularAreaClase(const EstadoSistema &X, CaracteristicasSistema &theta,
+                                  int clase, real_sim tiempo);
+    static void cerrarAreasClase(const EstadoSistema &X, CaracteristicasSistema &theta,
+                                 const TiempoEspacio &T);
+};
+
+class ModuloClases {
+public:
+    static bool cargarClases(ClasesClientes &clases, FILE *archivo);
+    static int elegirClase(const ClasesClientes &clases);
+};
+
+class ModuloPerfil {
+public:
+    static bool cargarPerfil(PerfilTasas &perfil, FILE *archivo);
+    static double tasaAcumulada(const PerfilTasas &perfil, double tiempo);
+    static double invertirTasaAcumulada(const PerfilTasas &perfil, double acumulada);
+    static int ventana(const PerfilTasas &perfil, double tiempo, double &fin_ventana);
 };
 
 class ModuloReportes {
 public:
     static void generarReporte(const CaracteristicasSistema &theta,
                               const TiempoEspacio &T,
+                              const DerivadasIPA &dtheta,
                               const ParametrosSistema &xi,
                               FILE *archivo_salida);
 };
 
+class ModuloGradientes {
+public:
+    static void programarEvento(DerivadasIPA &dtheta, int evento, int parametro,
+                                real_sim muestra, real_sim media);
+    static void gradientesAnaliticosMM1(const ParametrosSistema &xi,
+                                        float d_espera[NUM_PARAMETROS_IPA],
+                                        float d_num_cola[NUM_PARAMETROS_IPA]);
+    static void estimarGradientes(const CaracteristicasSistema &theta, const TiempoEspacio &T,
+                                  const DerivadasIPA &dtheta,
+                                  real_sim d_espera[NUM_PARAMETROS_IPA],
+                                  real_sim d_num_cola[NUM_PARAMETROS_IPA]);
+};
+
 class ModuloRegistro {
 public:
     static void inicializarRegistro(RegistroEventos &registro, const char *nombre_archivo);
@@ -115,18 +317,33 @@ public:
     static void finalizarRegistro(RegistroEventos &registro);
 };
 
+class ModuloCache {
+public:
+    static unsigned long long calcularClave(const ParametrosSistema &xi,
+                                            const EstadoAleatorio &estado_inicial);
+    static bool buscar(const char *nombre_archivo, const ParametrosSistema &xi,
+                       const EstadoAleatorio &estado_inicial, EntradaCache &entrada);
+    static void guardar(const char *nombre_archivo, const EntradaCache &entrada);
+};
+
 class SimuladorPrincipal {
 private:
     ParametrosSistema xi;
     TiempoEspacio T;
     EstadoSistema X;
     CaracteristicasSistema theta;
+    DerivadasIPA dtheta;
     ListaEventos L;
+    PerfilTasas perfil;
+    ClasesClientes clases;
 
 public:
     void ejecutarSimulacion(const char *archivo_parametros,
                            const char *archivo_resultados,
-                           const char *archivo_log = "eventos_clientes.csv");
+                           const char *archivo_log = "eventos_clientes.csv",
+                           const char *archivo_cache = NULL, // NULL: sin caché
+                           const char *archivo_perfil = "perfil_tasas.txt",
+                           const char *archivo_clases = "clases.txt");
 };
 
 #endif // SISTEMA_DE_COLAS_MODULO_H
\ No newline at end of file
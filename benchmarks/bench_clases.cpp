@@ -0,0 +1,78 @@
+/* Benchmark del costo por evento según el número de clases de prioridad */
+
+#define SIN_MAIN
+#include "../SistemaDeColasModulo.cpp"
+#include "bench_comun.h"
+
+#define NOMBRE_MOTOR "clases"
+#define NUM_CLIENTES 2000000
+#define UTILIZACION 0.8
+#define MEDIA_ATENCION 0.1
+
+/* Clases con la misma tasa y utilización total UTILIZACION */
+static void construirClases(ClasesClientes &clases, int num_clases, int apropiativa)
+{
+    FILE *archivo = tmpfile();
+    fprintf(archivo, "%s\n", apropiativa ? "APROPIATIVA" : "NO_APROPIATIVA");
+    for (int c = 0; c < num_clases; ++c)
+    {
+        fprintf(archivo, "%f %f\n", num_clases * MEDIA_ATENCION / UTILIZACION, MEDIA_ATENCION);
+    }
+    rewind(archivo);
+
+    if (!ModuloClases::cargarClases(clases, archivo))
+    {
+        fprintf(stderr, "No se pudieron construir %d clases\n", num_clases);
+        exit(1);
+    }
+    fclose(archivo);
+}
+
+static MotorModular motor;
+
+/* Corre el ciclo principal sin archivos y reporta el costo por evento */
+static void medir(SalidaJSON &salida, int num_clases, int apropiativa)
+{
+    ClasesClientes clases;
+    ParametrosSistema xi;
+
+    construirClases(clases, num_clases, apropiativa);
+    xi.media_entre_llegadas = MEDIA_ATENCION / UTILIZACION;
+    xi.media_atencion = MEDIA_ATENCION;
+    xi.num_esperas_requerido = NUM_CLIENTES;
+    xi.num_eventos = 2;
+    xi.perfil = NULL;
+    xi.clases = &clases;
+
+    // Sin archivo de log: escribirEventoCliente no escribe nada
+    iniciarMotor(motor, xi, NULL);
+    double inicio = ahoraNs();
+    long long eventos = avanzarMotor(motor, NUM_CLIENTES, NULL, NULL);
+    double ns = ahoraNs() - inicio;
+
+    // El número de clases y la disciplina van en el nombre de la medición
+    char medicion[MAX_MEDICION];
+    snprintf(medicion, sizeof(medicion), "ns_por_evento:%s:%d_clases",
+             apropiativa ? "apropiativa" : "no_apropiativa", num_clases);
+    emitirResultado(salida, NOMBRE_MOTOR, medicion, UTILIZACION, NUM_CLIENTES, ns / eventos,
+                    "ns/evento");
+    fprintf(stderr, "(espera promedio %.3f)\n",
+            (double)ModuloPrecision::valor(motor.theta.total_de_esperas) / motor.theta.num_clientes_espera);
+}
+
+int main(int argc, char *argv[])
+{
+    SalidaJSON salida;
+    abrirJSON(salida, argc > 1 ? argv[1] : NOMBRE_MOTOR ".json");
+
+    for (int apropiativa = 0; apropiativa <= 1; ++apropiativa)
+    {
+        for (int num_clases = 1; num_clases <= MAX_CLASES; num_clases *= 2)
+        {
+            medir(salida, num_clases, apropiativa);
+        }
+    }
+
+    cerrarJSON(salida);
+    return 0;
+}
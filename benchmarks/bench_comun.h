@@ -0,0 +1,168 @@
+#ifndef BENCH_COMUN_H
+#define BENCH_COMUN_H
+
+/* Utilidades compartidas por la suite de benchmarks de ambos motores */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+/* ========== MATRIZ DE ESCENARIOS ========== */
+#define MEDIA_ATENCION_BENCH 0.1027 // La de param.txt; la llegada se ajusta a cada ρ
+#define NUM_RHOS 3
+#define NUM_LONGITUDES 3
+#define NUM_VARIABLES_RNG 10000000
+#define NUM_LINEAS_LOG 1000000
+#define MAX_MEDICION 64 // Largo máximo del nombre de una medición (MAX_TEXTO en comparar_resultados)
+
+static const double RHOS[NUM_RHOS] = {0.5, 0.7, 0.8}; // Con 0.9 la cola de 100 se desborda
+static const long long LONGITUDES[NUM_LONGITUDES] = {10000, 100000, 1000000};
+
+/* ========== CRONÓMETRO ========== */
+static inline double ahoraNs()
+{
+    return std::chrono::duration<double, std::nano>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* Costo de tomar dos lecturas seguidas, incluido en cada llamada medida por módulo */
+static inline double costoCronometro()
+{
+    const int repeticiones = 1000000;
+    double total = 0.0;
+    for (int i = 0; i < repeticiones; ++i)
+    {
+        double inicio = ahoraNs();
+        total += ahoraNs() - inicio;
+    }
+    return total / repeticiones;
+}
+
+/* ========== SALIDA JSON ========== */
+// Un arreglo JSON con un objeto plano por línea, para que comparar_resultados
+// lo pueda leer sin dependencias
+struct SalidaJSON {
+    FILE *archivo;
+    int num_resultados;
+};
+
+static inline void abrirJSON(SalidaJSON &salida, const char *nombre_archivo)
+{
+    salida.archivo = fopen(nombre_archivo, "w");
+    if (!salida.archivo)
+    {
+        fprintf(stderr, "Error al crear archivo de resultados: %s\n", nombre_archivo);
+        exit(1);
+    }
+    salida.num_resultados = 0;
+    fprintf(salida.archivo, "[\n");
+}
+
+static inline void emitirResultado(SalidaJSON &salida, const char *motor, const char *medicion,
+                                   double rho, long long clientes, double valor, const char *unidad)
+{
+    fprintf(salida.archivo,
+            "%s{\"motor\": \"%s\", \"medicion\": \"%s\", \"rho\": %.2f, \"clientes\": %lld, "
+            "\"valor\": %.6g, \"unidad\": \"%s\"}",
+            salida.num_resultados > 0 ? ",\n" : "", motor, medicion, rho, clientes, valor, unidad);
+    ++salida.num_resultados;
+
+    // Progreso por stderr: stdout lo usa el motor legado
+    fprintf(stderr, "%-18s %-32s rho=%.2f clientes=%-8lld %14.1f %s\n",
+            motor, medicion, rho, clientes, valor, unidad);
+}
+
+static inline void cerrarJSON(SalidaJSON &salida)
+{
+    fprintf(salida.archivo, "\n]\n");
+    fclose(salida.archivo);
+}
+
+/* ========== CICLO DEL MOTOR MODULAR ========== */
+// Sólo para los benchmarks que incluyen SistemaDeColasModulo.cpp
+#ifdef SISTEMA_DE_COLAS_MODULO_H
+#define NUM_MODULOS_MODULAR 4
+#define MODULO_MANEJO_TIEMPO 0
+#define MODULO_ESTADISTICAS 1
+#define MODULO_LLEGADA 2
+#define MODULO_SALIDA 3
+
+// Estado completo de una corrida; conviene declararlo static por su tamaño
+struct MotorModular {
+    ParametrosSistema xi;
+    TiempoEspacio T;
+    EstadoSistema X;
+    CaracteristicasSistema theta;
+    DerivadasIPA dtheta;
+    ListaEventos L;
+    RegistroEventos registro;
+};
+
+/* Inicializa una corrida con los parámetros xi; log NULL corre sin registro de eventos */
+static inline void iniciarMotor(MotorModular &motor, const ParametrosSistema &xi, FILE *log)
+{
+    motor.xi = xi;
+    memset(&motor.registro, 0, sizeof(motor.registro));
+    motor.registro.archivo_log = log;
+    motor.registro.ultimo_tiempo_llegada = -1.0;
+    ModuloInicializacion::inicializar(motor.T, motor.X, motor.theta, motor.L, motor.dtheta, motor.xi);
+}
+
+/* Avanza la corrida hasta clientes_objetivo y devuelve los eventos procesados;
+   si tiempos != NULL acumula los ns y las llamadas de cada módulo (MODULO_*) */
+static inline long long avanzarMotor(MotorModular &motor, long long clientes_objetivo,
+                                     double *tiempos, long long *llamadas)
+{
+    long long eventos = 0;
+    while (motor.theta.num_clientes_espera < clientes_objetivo)
+    {
+        if (tiempos)
+        {
+            double t0 = ahoraNs();
+            int tipo_evento = ModuloManejoTiempo::manejoTiempoEspacio(motor.T, motor.L, motor.dtheta, motor.xi);
+            double t1 = ahoraNs();
+            ModuloEventos::actualizarEstadisticasPromedio(motor.X, motor.theta, motor.T, motor.dtheta, motor.xi);
+            double t2 = ahoraNs();
+            int modulo = (tipo_evento == EVENTO_LLEGADA) ? MODULO_LLEGADA : MODULO_SALIDA;
+            if (tipo_evento == EVENTO_LLEGADA)
+            {
+                ModuloEventos::eventoLlegada(motor.X, motor.theta, motor.L, motor.T, motor.dtheta,
+                                             motor.xi, motor.registro);
+            }
+            else
+            {
+                ModuloEventos::eventoSalida(motor.X, motor.theta, motor.L, motor.T, motor.dtheta,
+                                            motor.xi, motor.registro);
+            }
+            double t3 = ahoraNs();
+
+            tiempos[MODULO_MANEJO_TIEMPO] += t1 - t0;
+            tiempos[MODULO_ESTADISTICAS] += t2 - t1;
+            tiempos[modulo] += t3 - t2;
+            ++llamadas[MODULO_MANEJO_TIEMPO];
+            ++llamadas[MODULO_ESTADISTICAS];
+            ++llamadas[modulo];
+        }
+        else
+        {
+            int tipo_evento = ModuloManejoTiempo::manejoTiempoEspacio(motor.T, motor.L, motor.dtheta, motor.xi);
+            ModuloEventos::actualizarEstadisticasPromedio(motor.X, motor.theta, motor.T, motor.dtheta, motor.xi);
+            switch (tipo_evento)
+            {
+            case EVENTO_LLEGADA:
+                ModuloEventos::eventoLlegada(motor.X, motor.theta, motor.L, motor.T, motor.dtheta,
+                                             motor.xi, motor.registro);
+                break;
+            case EVENTO_SALIDA:
+                ModuloEventos::eventoSalida(motor.X, motor.theta, motor.L, motor.T, motor.dtheta,
+                                            motor.xi, motor.registro);
+                break;
+            }
+        }
+        ++eventos;
+    }
+    return eventos;
+}
+#endif // SISTEMA_DE_COLAS_MODULO_H
+
+#endif // BENCH_COMUN_H
@@ -0,0 +1,144 @@
+/* Benchmark del motor legado (Sistema de Colas.cpp); con -DSILENCIOSO sin printf */
+
+#define SIN_MAIN
+#include "../Sistema de Colas.cpp"
+#include "bench_comun.h"
+
+#ifdef SILENCIOSO
+#define NOMBRE_MOTOR "legado_silencioso"
+#else
+#define NOMBRE_MOTOR "legado"
+#endif
+
+#define NUM_MODULOS_LEGADO 4
+
+static const char *NOMBRES_MODULOS[NUM_MODULOS_LEGADO] = {
+    "modulo:controltiempo", "modulo:actualizar_estad_prom_tiempo",
+    "modulo:llegada", "modulo:salida"};
+
+/* Corre el motor hasta num_clientes; si tiempos != NULL mide cada módulo por llamada */
+static long long correr(double rho, long long num_clientes, double *tiempos, long long *llamadas)
+{
+    media_atencion = MEDIA_ATENCION_BENCH;
+    media_entre_llegadas = MEDIA_ATENCION_BENCH / rho;
+    num_esperas_requerido = (int)num_clientes;
+    num_eventos = 2;
+
+    long long eventos = 0;
+    inicializar();
+    while (num_clientes_espera < num_esperas_requerido)
+    {
+        if (tiempos)
+        {
+            double t0 = ahoraNs();
+            controltiempo();
+            double t1 = ahoraNs();
+            actualizar_estad_prom_tiempo();
+            double t2 = ahoraNs();
+            int modulo = (sig_tipo_evento == 1) ? 2 : 3;
+            if (sig_tipo_evento == 1)
+            {
+                llegada();
+            }
+            else
+            {
+                salida();
+            }
+            double t3 = ahoraNs();
+
+            tiempos[0] += t1 - t0;
+            tiempos[1] += t2 - t1;
+            tiempos[modulo] += t3 - t2;
+            ++llamadas[0];
+            ++llamadas[1];
+            ++llamadas[modulo];
+        }
+        else
+        {
+            controltiempo();
+            actualizar_estad_prom_tiempo();
+            switch (sig_tipo_evento) {
+                case 1:
+                    llegada();
+                    break;
+                case 2:
+                    salida();
+                    break;
+            }
+        }
+        ++eventos;
+    }
+    return eventos;
+}
+
+int main(int argc, char *argv[])
+{
+    SalidaJSON salida;
+    abrirJSON(salida, argc > 1 ? argv[1] : NOMBRE_MOTOR ".json");
+
+    // Los mensajes de error del motor van a resultados
+    resultados = tmpfile();
+
+    // Las mediciones por módulo incluyen este costo; se reporta aparte
+    emitirResultado(salida, NOMBRE_MOTOR, "costo_cronometro", 0.0, 0, costoCronometro(),
+                    "ns/llamada");
+
+    // Matriz ρ × longitud de corrida
+    for (int r = 0; r < NUM_RHOS; ++r)
+    {
+        for (int l = 0; l < NUM_LONGITUDES; ++l)
+        {
+            double inicio = ahoraNs();
+            long long eventos = correr(RHOS[r], LONGITUDES[l], NULL, NULL);
+            double ns = ahoraNs() - inicio;
+            emitirResultado(salida, NOMBRE_MOTOR, "eventos_por_segundo", RHOS[r], LONGITUDES[l],
+                            eventos * 1.0e9 / ns, "eventos/s");
+            emitirResultado(salida, NOMBRE_MOTOR, "ns_por_evento", RHOS[r], LONGITUDES[l],
+                            ns / eventos, "ns/evento");
+
+            double tiempos[NUM_MODULOS_LEGADO] = {0.0};
+            long long llamadas[NUM_MODULOS_LEGADO] = {0};
+            correr(RHOS[r], LONGITUDES[l], tiempos, llamadas);
+            for (int m = 0; m < NUM_MODULOS_LEGADO; ++m)
+            {
+                emitirResultado(salida, NOMBRE_MOTOR, NOMBRES_MODULOS[m], RHOS[r], LONGITUDES[l],
+                                llamadas[m] > 0 ? tiempos[m] / llamadas[m] : 0.0,
+                                "ns/llamada");
+            }
+        }
+    }
+
+    // Generador: lcgrand sola y expon (que imprime cada variable en la versión normal)
+    double inicio = ahoraNs();
+    double suma = 0.0;
+    for (int i = 0; i < NUM_VARIABLES_RNG; ++i)
+    {
+        suma += lcgrand(1);
+    }
+    emitirResultado(salida, NOMBRE_MOTOR, "rng:lcgrand", 0.0, NUM_VARIABLES_RNG,
+                    NUM_VARIABLES_RNG * 1.0e9 / (ahoraNs() - inicio), "variables/s");
+
+    inicio = ahoraNs();
+    for (int i = 0; i < NUM_VARIABLES_RNG; ++i)
+    {
+        suma += expon(MEDIA_ATENCION_BENCH);
+    }
+    emitirResultado(salida, NOMBRE_MOTOR, "rng:expon", 0.0, NUM_VARIABLES_RNG,
+                    NUM_VARIABLES_RNG * 1.0e9 / (ahoraNs() - inicio), "variables/s");
+
+#ifndef SILENCIOSO
+    // Registro: el motor legado escribe en stdout una línea por variable aleatoria
+    inicio = ahoraNs();
+    for (int i = 0; i < NUM_LINEAS_LOG; ++i)
+    {
+        printf("lcgrand(1) = %.10f\n", 0.5);
+    }
+    fflush(stdout);
+    emitirResultado(salida, NOMBRE_MOTOR, "log:stdout", 0.0, NUM_LINEAS_LOG,
+                    NUM_LINEAS_LOG * 1.0e9 / (ahoraNs() - inicio), "lineas/s");
+#endif
+
+    fprintf(stderr, "(suma de control %f)\n", suma);
+    cerrarJSON(salida);
+    return 0;
+}
@@ -0,0 +1,79 @@
+/* Benchmark de generación de llegadas: homogénea vs. perfil no homogéneo */
+
+#define SIN_MAIN
+#include "../SistemaDeColasModulo.cpp"
+#include "bench_comun.h"
+
+#define NOMBRE_MOTOR "llegadas"
+#define NUM_LLEGADAS 10000000
+
+/* Perfil de un día con oscilación pico/valle de 100x */
+static void construirPerfilPrueba(PerfilTasas &perfil, int modo)
+{
+    perfil.modo = modo;
+    perfil.num_puntos = MAX_VENTANAS + 1;
+    perfil.acumulada[0] = 0.0;
+    for (int i = 0; i < perfil.num_puntos; ++i)
+    {
+        double fase = 2.0 * M_PI * i / MAX_VENTANAS;
+        perfil.tiempo[i] = 15.0 * i;
+        perfil.tasa[i] = 0.1 * pow(100.0, 0.5 * (1.0 - cos(fase)));
+    }
+    for (int i = 0; i + 1 < perfil.num_puntos; ++i)
+    {
+        double ancho = perfil.tiempo[i + 1] - perfil.tiempo[i];
+        double masa = (modo == PERFIL_CONSTANTE)
+                          ? perfil.tasa[i] * ancho
+                          : 0.5 * (perfil.tasa[i] + perfil.tasa[i + 1]) * ancho;
+        perfil.acumulada[i + 1] = perfil.acumulada[i] + masa;
+    }
+}
+
+/* Genera NUM_LLEGADAS llegadas y reporta el rendimiento */
+static void medir(SalidaJSON &salida, const char *nombre, const ParametrosSistema &xi)
+{
+    double tiempo = 0.0;
+    double inicio = ahoraNs();
+    for (int i = 0; i < NUM_LLEGADAS; ++i)
+    {
+        tiempo += ModuloPercentil::percentilEntreLlegadas(xi, tiempo);
+    }
+    double ns = ahoraNs() - inicio;
+
+    char medicion[MAX_MEDICION];
+    snprintf(medicion, sizeof(medicion), "llegadas_por_segundo:%s", nombre);
+    emitirResultado(salida, NOMBRE_MOTOR, medicion, 0.0, NUM_LLEGADAS,
+                    NUM_LLEGADAS * 1.0e9 / ns, "llegadas/s");
+    snprintf(medicion, sizeof(medicion), "ns_por_llegada:%s", nombre);
+    emitirResultado(salida, NOMBRE_MOTOR, medicion, 0.0, NUM_LLEGADAS,
+                    ns / NUM_LLEGADAS, "ns/llegada");
+    fprintf(stderr, "(reloj final %.1f)\n", tiempo);
+}
+
+int main(int argc, char *argv[])
+{
+    SalidaJSON salida;
+    abrirJSON(salida, argc > 1 ? argv[1] : NOMBRE_MOTOR ".json");
+
+    PerfilTasas constante, lineal;
+    construirPerfilPrueba(constante, PERFIL_CONSTANTE);
+    construirPerfilPrueba(lineal, PERFIL_LINEAL);
+
+    ParametrosSistema xi;
+    xi.media_entre_llegadas = 0.1450;
+    xi.media_atencion = 0.1027;
+    xi.num_esperas_requerido = 0;
+    xi.num_eventos = 2;
+    xi.clases = NULL;
+
+    // La inversión de Λ no rechaza candidatos: una variable uniforme por llegada
+    xi.perfil = NULL;
+    medir(salida, "homogenea", xi);
+    xi.perfil = &constante;
+    medir(salida, "perfil_constante", xi);
+    xi.perfil = &lineal;
+    medir(salida, "perfil_lineal", xi);
+
+    cerrarJSON(salida);
+    return 0;
+}
@@ -0,0 +1,115 @@
+/* Benchmark del motor modular (SistemaDeColasModulo.cpp); con -DSIN_LOG sin eventos_clientes.csv */
+
+#define SIN_MAIN
+#include "../SistemaDeColasModulo.cpp"
+#include "bench_comun.h"
+
+#ifdef SIN_LOG
+#define NOMBRE_MOTOR "modular_sin_log"
+#else
+#define NOMBRE_MOTOR "modular"
+#endif
+
+static const char *NOMBRES_MODULOS[NUM_MODULOS_MODULAR] = {
+    "modulo:manejoTiempoEspacio", "modulo:actualizarEstadisticasPromedio",
+    "modulo:eventoLlegada", "modulo:eventoSalida"};
+
+static MotorModular motor;
+
+/* Corre el motor hasta num_clientes; si tiempos != NULL mide cada módulo por llamada */
+static long long correr(double rho, long long num_clientes, FILE *log,
+                        double *tiempos, long long *llamadas)
+{
+    ParametrosSistema xi;
+    xi.media_atencion = MEDIA_ATENCION_BENCH;
+    xi.media_entre_llegadas = MEDIA_ATENCION_BENCH / rho;
+    xi.num_esperas_requerido = num_clientes;
+    xi.num_eventos = 2;
+    xi.perfil = NULL;
+    xi.clases = NULL;
+
+    iniciarMotor(motor, xi, log);
+    return avanzarMotor(motor, num_clientes, tiempos, llamadas);
+}
+
+int main(int argc, char *argv[])
+{
+    SalidaJSON salida;
+    abrirJSON(salida, argc > 1 ? argv[1] : NOMBRE_MOTOR ".json");
+
+#ifdef SIN_LOG
+    FILE *log = NULL;
+#else
+    // Mismo registro que ejecutarSimulacion: una línea con fflush por cliente
+    FILE *log = tmpfile();
+#endif
+
+    // Las mediciones por módulo incluyen este costo; se reporta aparte
+    emitirResultado(salida, NOMBRE_MOTOR, "costo_cronometro", 0.0, 0, costoCronometro(),
+                    "ns/llamada");
+
+    // Matriz ρ × longitud de corrida
+    for (int r = 0; r < NUM_RHOS; ++r)
+    {
+        for (int l = 0; l < NUM_LONGITUDES; ++l)
+        {
+            double inicio = ahoraNs();
+            long long eventos = correr(RHOS[r], LONGITUDES[l], log, NULL, NULL);
+            double ns = ahoraNs() - inicio;
+            emitirResultado(salida, NOMBRE_MOTOR, "eventos_por_segundo", RHOS[r], LONGITUDES[l],
+                            eventos * 1.0e9 / ns, "eventos/s");
+            emitirResultado(salida, NOMBRE_MOTOR, "ns_por_evento", RHOS[r], LONGITUDES[l],
+                            ns / eventos, "ns/evento");
+
+            double tiempos[NUM_MODULOS_MODULAR] = {0.0};
+            long long llamadas[NUM_MODULOS_MODULAR] = {0};
+            correr(RHOS[r], LONGITUDES[l], log, tiempos, llamadas);
+            for (int m = 0; m < NUM_MODULOS_MODULAR; ++m)
+            {
+                emitirResultado(salida, NOMBRE_MOTOR, NOMBRES_MODULOS[m], RHOS[r], LONGITUDES[l],
+                                llamadas[m] > 0 ? tiempos[m] / llamadas[m] : 0.0,
+                                "ns/llamada");
+            }
+        }
+    }
+
+    // Generador: lcgrand sola y percentilExponencial
+    double inicio = ahoraNs();
+    double suma = 0.0;
+    for (int i = 0; i < NUM_VARIABLES_RNG; ++i)
+    {
+        suma += lcgrand(FLUJO_ALEATORIO);
+    }
+    emitirResultado(salida, NOMBRE_MOTOR, "rng:lcgrand", 0.0, NUM_VARIABLES_RNG,
+                    NUM_VARIABLES_RNG * 1.0e9 / (ahoraNs() - inicio), "variables/s");
+
+    inicio = ahoraNs();
+    for (int i = 0; i < NUM_VARIABLES_RNG; ++i)
+    {
+        suma += ModuloPercentil::percentilExponencial(MEDIA_ATENCION_BENCH);
+    }
+    emitirResultado(salida, NOMBRE_MOTOR, "rng:percentilExponencial", 0.0, NUM_VARIABLES_RNG,
+                    NUM_VARIABLES_RNG * 1.0e9 / (ahoraNs() - inicio), "variables/s");
+
+#ifndef SIN_LOG
+    // Registro: escribirEventoCliente hace fflush en cada línea
+    DatosCliente cliente;
+    cliente.numero = 1;
+    cliente.tiempo_entre_llegadas = 0.145;
+    cliente.tiempo_atencion = 0.1027;
+    cliente.tiempo_llegada = 0.0;
+
+    inicio = ahoraNs();
+    for (int i = 0; i < NUM_LINEAS_LOG; ++i)
+    {
+        ModuloRegistro::escribirEventoCliente(cliente, log);
+    }
+    emitirResultado(salida, NOMBRE_MOTOR, "log:escribirEventoCliente", 0.0, NUM_LINEAS_LOG,
+                    NUM_LINEAS_LOG * 1.0e9 / (ahoraNs() - inicio), "lineas/s");
+    fclose(log);
+#endif
+
+    fprintf(stderr, "(suma de control %f)\n", suma);
+    cerrarJSON(salida);
+    return 0;
+}
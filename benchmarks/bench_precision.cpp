@@ -0,0 +1,168 @@
+/* Benchmark de precisión en corridas largas: compilar con y sin -DCORRIDA_LARGA */
+
+#define SIN_MAIN
+#include "../SistemaDeColasModulo.cpp"
+#include "bench_comun.h"
+
+#ifdef CORRIDA_LARGA
+#define NOMBRE_MOTOR "precision_larga"
+#define EXPONENTE_MAXIMO 18 // Potencias de 10 que caben en long long
+#else
+#define NOMBRE_MOTOR "precision"
+// Con reloj float, hacia 3·10^7 clientes (t ≈ 4.2·10^6 min) la resolución del reloj
+// (0.5 min) supera las medias de llegada y atención: la cola crece hasta LIMITE_COLA,
+// eventoLlegada reporta el desbordamiento y el motor termina con exit(2)
+#define EXPONENTE_MAXIMO 7
+#endif
+
+#define MEDIA_ENTRE_LLEGADAS 0.1450
+#define MEDIA_ATENCION 0.1027
+#define CLIENTES_VERIFICACION 1000000LL // Desde aquí se comparan los estimados con M/M/1
+#define CLIENTES_MEDICION 10000LL        // Desde aquí se emite ns_por_evento al JSON
+#define MAX_PUNTOS (EXPONENTE_MAXIMO + 1)
+
+static MotorModular motor;
+
+/* Error relativo admitido con n clientes: 3 % en 10^6, que baja como 1/√n hasta 0.5 % */
+static double tolerancia(long long clientes)
+{
+    double tolerancia = 0.03 * sqrt((double)CLIENTES_VERIFICACION / clientes);
+    return (tolerancia > 0.005) ? tolerancia : 0.005;
+}
+
+/* Para los gradientes IPA: 10 % en 10^6, que baja como 1/√n hasta 2 % */
+static double toleranciaGradientes(long long clientes)
+{
+    double tolerancia = 0.10 * sqrt((double)CLIENTES_VERIFICACION / clientes);
+    return (tolerancia > 0.02) ? tolerancia : 0.02;
+}
+
+static bool dentroDeTolerancia(double estimado, double referencia, double tolerancia)
+{
+    return fabs(estimado - referencia) <= tolerancia * fabs(referencia);
+}
+
+/* Corre hasta 10^exponente clientes, imprime los estimados en cada potencia de 10
+   y, desde 10^6 clientes, los verifica contra M/M/1 junto con los gradientes IPA;
+   se detiene en la primera falla y termina con 1. Uso: bench_precision [archivo.json] [exponente] */
+int main(int argc, char *argv[])
+{
+    SalidaJSON salida;
+    abrirJSON(salida, argc > 1 ? argv[1] : NOMBRE_MOTOR ".json");
+
+    int exponente_maximo = (argc > 2) ? atoi(argv[2]) : 10;
+    if (exponente_maximo > EXPONENTE_MAXIMO)
+    {
+        fprintf(stderr, "Exponente %d reducido a %d: más allá el reloj de %d bytes no alcanza\n",
+                exponente_maximo, EXPONENTE_MAXIMO, (int)sizeof(real_sim));
+        exponente_maximo = EXPONENTE_MAXIMO;
+    }
+
+    ParametrosSistema xi;
+    xi.media_entre_llegadas = MEDIA_ENTRE_LLEGADAS;
+    xi.media_atencion = MEDIA_ATENCION;
+    xi.num_esperas_requerido = 1;
+    xi.num_eventos = 2;
+    xi.perfil = NULL;
+    xi.clases = NULL;
+    for (int i = 0; i < exponente_maximo; ++i)
+    {
+        xi.num_esperas_requerido *= 10;
+    }
+
+    // Valores analíticos M/M/1
+    double rho = MEDIA_ATENCION / MEDIA_ENTRE_LLEGADAS;
+    double espera_mm1 = MEDIA_ATENCION * MEDIA_ATENCION / (MEDIA_ENTRE_LLEGADAS - MEDIA_ATENCION);
+    double cola_mm1 = rho * rho / (1.0 - rho);
+    float d_espera_mm1[NUM_PARAMETROS_IPA], d_cola_mm1[NUM_PARAMETROS_IPA];
+    ModuloGradientes::gradientesAnaliticosMM1(xi, d_espera_mm1, d_cola_mm1);
+
+    printf("Modo: %s (reloj de %d bytes)\n",
+#ifdef CORRIDA_LARGA
+           "corrida larga, MRG32k3a",
+#else
+           "float, lcgrand",
+#endif
+           (int)sizeof(real_sim));
+    printf("%14s %16s %10s %10s %10s %10s %8s\n", "Clientes", "Reloj", "Espera", "En cola",
+           "Uso", "ns/evento", "M/M/1");
+    printf("%14s %16s %10.4f %10.4f %10.4f\n", "M/M/1", "", espera_mm1, cola_mm1, rho);
+
+    // Gradientes IPA en cada potencia de 10, para la tabla final
+    long long clientes_punto[MAX_PUNTOS];
+    real_sim d_espera_punto[MAX_PUNTOS][NUM_PARAMETROS_IPA];
+    real_sim d_cola_punto[MAX_PUNTOS][NUM_PARAMETROS_IPA];
+    int num_puntos = 0;
+
+    long long num_eventos = 0;
+    bool falla = false;
+    const CaracteristicasSistema &theta = motor.theta;
+    const TiempoEspacio &T = motor.T;
+
+    // Sin archivo de log: escribirEventoCliente no escribe nada
+    iniciarMotor(motor, xi, NULL);
+    double inicio = ahoraNs();
+    for (long long n = 10; n <= xi.num_esperas_requerido && !falla; n *= 10)
+    {
+        num_eventos += avanzarMotor(motor, n, NULL, NULL);
+
+        double ns_por_evento = (ahoraNs() - inicio) / num_eventos;
+        double espera = (double)ModuloPrecision::valor(theta.total_de_esperas) / n;
+        double cola = (double)ModuloPrecision::valor(theta.area_num_entra_cola) / T.tiempo_simulacion;
+        double uso = (double)ModuloPrecision::valor(theta.area_estado_servidor) / T.tiempo_simulacion;
+
+        clientes_punto[num_puntos] = n;
+        ModuloGradientes::estimarGradientes(theta, T, motor.dtheta, d_espera_punto[num_puntos],
+                                            d_cola_punto[num_puntos]);
+        ++num_puntos;
+
+        const char *verificacion = "";
+        if (n >= CLIENTES_VERIFICACION)
+        {
+            bool bien = dentroDeTolerancia(espera, espera_mm1, tolerancia(n)) &&
+                        dentroDeTolerancia(cola, cola_mm1, tolerancia(n)) &&
+                        dentroDeTolerancia(uso, rho, tolerancia(n));
+            verificacion = bien ? "OK" : "FALLA";
+            falla = falla || !bien;
+        }
+        printf("%14lld %16.3f %10.4f %10.4f %10.4f %10.1f %8s\n", n,
+               (double)T.tiempo_simulacion, espera, cola, uso, ns_por_evento, verificacion);
+        fflush(stdout);
+        if (n >= CLIENTES_MEDICION)
+        {
+            emitirResultado(salida, NOMBRE_MOTOR, "ns_por_evento", rho, n, ns_por_evento, "ns/evento");
+        }
+    }
+
+    // Gradientes IPA contra las derivadas analíticas de M/M/1
+    printf("\nGradientes IPA (a = media_entre_llegadas, s = media_atencion)\n");
+    printf("%14s %10s %10s %10s %10s %8s\n", "Clientes", "dWq/da", "dWq/ds", "dLq/da", "dLq/ds",
+           "M/M/1");
+    printf("%14s %10.4f %10.4f %10.4f %10.4f\n", "M/M/1",
+           d_espera_mm1[PARAM_ENTRE_LLEGADAS], d_espera_mm1[PARAM_ATENCION],
+           d_cola_mm1[PARAM_ENTRE_LLEGADAS], d_cola_mm1[PARAM_ATENCION]);
+    for (int i = 0; i < num_puntos; ++i)
+    {
+        const char *verificacion = "";
+        if (clientes_punto[i] >= CLIENTES_VERIFICACION)
+        {
+            bool bien = true;
+            for (int p = 0; p < NUM_PARAMETROS_IPA; ++p)
+            {
+                double tolerancia_punto = toleranciaGradientes(clientes_punto[i]);
+                bien = bien &&
+                       dentroDeTolerancia(d_espera_punto[i][p], d_espera_mm1[p], tolerancia_punto) &&
+                       dentroDeTolerancia(d_cola_punto[i][p], d_cola_mm1[p], tolerancia_punto);
+            }
+            verificacion = bien ? "OK" : "FALLA";
+            falla = falla || !bien;
+        }
+        printf("%14lld %10.4f %10.4f %10.4f %10.4f %8s\n", clientes_punto[i],
+               (double)d_espera_punto[i][PARAM_ENTRE_LLEGADAS], (double)d_espera_punto[i][PARAM_ATENCION],
+               (double)d_cola_punto[i][PARAM_ENTRE_LLEGADAS], (double)d_cola_punto[i][PARAM_ATENCION],
+               verificacion);
+    }
+
+    cerrarJSON(salida);
+    return falla ? 1 : 0;
+}
@@ -0,0 +1,136 @@
+/* Compara resultados de benchmark contra una línea base y marca las regresiones */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_RESULTADOS 1024
+#define MAX_TEXTO 64
+#define UMBRAL_POR_DEFECTO 10.0 // Porcentaje de empeoramiento tolerado
+
+struct Resultado {
+    char motor[MAX_TEXTO];
+    char medicion[MAX_TEXTO];
+    char unidad[MAX_TEXTO];
+    double rho;
+    long long clientes;
+    double valor;
+};
+
+/* Lee el texto del campo "nombre": "..." de un objeto plano */
+static bool leerTexto(const char *linea, const char *nombre, char *destino)
+{
+    char patron[MAX_TEXTO];
+    snprintf(patron, sizeof(patron), "\"%s\": \"", nombre);
+    const char *inicio = strstr(linea, patron);
+    if (!inicio)
+    {
+        return false;
+    }
+    inicio += strlen(patron);
+    const char *fin = strchr(inicio, '"');
+    if (!fin || fin - inicio >= MAX_TEXTO)
+    {
+        return false;
+    }
+    memcpy(destino, inicio, fin - inicio);
+    destino[fin - inicio] = '\0';
+    return true;
+}
+
+/* Lee el número del campo "nombre": valor de un objeto plano */
+static bool leerNumero(const char *linea, const char *nombre, double &destino)
+{
+    char patron[MAX_TEXTO];
+    snprintf(patron, sizeof(patron), "\"%s\": ", nombre);
+    const char *inicio = strstr(linea, patron);
+    if (!inicio)
+    {
+        return false;
+    }
+    destino = strtod(inicio + strlen(patron), NULL);
+    return true;
+}
+
+/* Lee un archivo generado por emitirResultado: un objeto por línea */
+static int leerResultados(const char *nombre_archivo, Resultado *resultados)
+{
+    FILE *archivo = fopen(nombre_archivo, "r");
+    if (!archivo)
+    {
+        fprintf(stderr, "Error al abrir archivo de resultados: %s\n", nombre_archivo);
+        exit(2);
+    }
+
+    char linea[512];
+    int n = 0;
+    while (n < MAX_RESULTADOS && fgets(linea, sizeof(linea), archivo))
+    {
+        Resultado &r = resultados[n];
+        double clientes;
+        if (leerTexto(linea, "motor", r.motor) && leerTexto(linea, "medicion", r.medicion) &&
+            leerTexto(linea, "unidad", r.unidad) && leerNumero(linea, "rho", r.rho) &&
+            leerNumero(linea, "clientes", clientes) && leerNumero(linea, "valor", r.valor))
+        {
+            r.clientes = (long long)clientes;
+            ++n;
+        }
+    }
+    fclose(archivo);
+    return n;
+}
+
+static Resultado base[MAX_RESULTADOS];
+static Resultado actual[MAX_RESULTADOS];
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Uso: %s linea_base.json actual.json [umbral_%%]\n", argv[0]);
+        return 2;
+    }
+    double umbral = (argc > 3) ? atof(argv[3]) : UMBRAL_POR_DEFECTO;
+
+    int num_base = leerResultados(argv[1], base);
+    int num_actual = leerResultados(argv[2], actual);
+    int regresiones = 0;
+
+    printf("%-18s %-38s %5s %9s %14s %14s %9s\n", "Motor", "Medición", "rho", "clientes",
+           "Base", "Actual", "Cambio");
+    for (int i = 0; i < num_actual; ++i)
+    {
+        const Resultado &a = actual[i];
+        if (strcmp(a.medicion, "costo_cronometro") == 0)
+        {
+            // Referencia para leer las mediciones por módulo, no un resultado del motor
+            continue;
+        }
+        for (int j = 0; j < num_base; ++j)
+        {
+            const Resultado &b = base[j];
+            if (strcmp(a.motor, b.motor) != 0 || strcmp(a.medicion, b.medicion) != 0 ||
+                a.rho != b.rho || a.clientes != b.clientes || b.valor == 0.0)
+            {
+                continue;
+            }
+
+            // En unidades "ns/..." menos es mejor; en ".../s" más es mejor
+            bool menos_es_mejor = strncmp(a.unidad, "ns", 2) == 0;
+            double cambio = 100.0 * (a.valor - b.valor) / b.valor;
+            double empeoramiento = menos_es_mejor ? cambio : -cambio;
+            bool regresion = empeoramiento > umbral;
+            if (regresion)
+            {
+                ++regresiones;
+            }
+
+            printf("%-18s %-38s %5.2f %9lld %14.1f %14.1f %+8.1f%%%s\n", a.motor, a.medicion,
+                   a.rho, a.clientes, b.valor, a.valor, cambio, regresion ? "  REGRESIÓN" : "");
+            break;
+        }
+    }
+
+    printf("\n%d regresiones mayores a %.1f%%\n", regresiones, umbral);
+    return regresiones > 0 ? 1 : 0;
+}